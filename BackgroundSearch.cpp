@@ -0,0 +1,176 @@
+#include "BackgroundSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+void BackgroundSearch::start(GridSnapshot snapshot, int startCell, const std::vector<int>& goalCells, float weight,
+    const std::vector<int>* exactH)
+{
+    cancel();
+
+    m_grid = std::move(snapshot);
+    m_start = startCell;
+    m_goals = goalCells;
+    m_weight = std::max(1.0f, weight);
+    if (exactH) m_exactH = *exactH;
+    else m_exactH.clear();
+    m_path.clear();
+
+    m_isGoal.assign(m_grid.cellCount(), 0);
+    for (int g : m_goals)
+        if (g >= 0 && g < m_grid.cellCount()) m_isGoal[g] = 1;
+
+    m_expanded.store(0, std::memory_order_relaxed);
+    m_workerMs.store(0.0, std::memory_order_relaxed);
+    m_thread = std::thread(&BackgroundSearch::run, this);
+}
+
+void BackgroundSearch::cancel()
+{
+    if (m_thread.joinable())
+    {
+        m_cancel.store(true, std::memory_order_relaxed);
+        m_thread.join();
+    }
+
+    // The worker is gone, so resetting the consumer-side state is safe
+    m_cancel.store(false, std::memory_order_relaxed);
+    m_events.clear();
+    m_grid = GridSnapshot();   // unpin it, so the chunks it shared can be freed
+}
+
+bool BackgroundSearch::emit(const Event& e)
+{
+    // Ring full: the UI is behind, wait for it instead of dropping paint events
+    while (!m_events.push(e))
+    {
+        if (m_cancel.load(std::memory_order_relaxed)) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void BackgroundSearch::run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+    auto finish = [&](const Event& e)
+        {
+            m_workerMs.store(std::chrono::duration<double, std::milli>(Clock::now() - t0).count(), std::memory_order_relaxed);
+            emit(e);
+        };
+
+    const int n = m_grid.cellCount();
+    const int cols = m_grid.cols;
+    Event noPath;
+    noPath.kind = Event::NoPath;
+
+    if (m_start < 0 || m_start >= n || m_goals.empty())
+    {
+        finish(noPath);
+        return;
+    }
+
+    auto heuristic = [&](int cell)
+        {
+            if (!m_exactH.empty()) return m_exactH[cell];
+            int best = 1 << 30;
+            for (int g : m_goals)
+                best = std::min(best, std::abs(cell / cols - g / cols) + std::abs(cell % cols - g % cols));
+            return best;
+        };
+
+    std::vector<int> g(n, 1 << 30);
+    std::vector<int> parent(n, -1);
+    std::vector<char> closed(n, 0);
+    std::vector<OpenEntry> heap;
+    std::greater<OpenEntry> cmp;
+
+    g[m_start] = 0;
+    const int h0 = heuristic(m_start);
+    heap.push_back({ m_weight * h0, h0, m_start });
+
+    static const int DR[4] = { -1, 1, 0, 0 };
+    static const int DC[4] = { 0, 0, -1, 1 };
+
+    int expanded = 0;
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        const OpenEntry top = heap.back();
+        heap.pop_back();
+
+        const int u = top.cell;
+        if (closed[u] || top.f != g[u] + m_weight * top.h) continue;   // stale entry
+        closed[u] = 1;
+        m_expanded.store(++expanded, std::memory_order_relaxed);
+
+        if (m_isGoal[u])
+        {
+            std::vector<int> cells;
+            for (int v = u; v != -1; v = parent[v])
+                cells.push_back(v);
+            std::reverse(cells.begin(), cells.end());
+            m_path = Path(std::move(cells), cols);
+
+            // Painted from the goal back to the start, like the visual search does it
+            const std::vector<int>& route = m_path.cells();
+            for (int i = (int)route.size() - 2; i > 0; i--)
+            {
+                Event e;
+                e.kind = Event::Path;
+                e.cell = route[i];
+                if (!emit(e)) return;
+            }
+
+            Event found;
+            found.kind = Event::Found;
+            found.cell = u;
+            found.value = g[u];
+            finish(found);
+            return;
+        }
+
+        if (u != m_start)
+        {
+            Event e;
+            e.kind = Event::Closed;
+            e.cell = u;
+            if (!emit(e)) return;
+        }
+
+        const int r = u / cols;
+        const int c = u % cols;
+        for (int d = 0; d < 4; d++)
+        {
+            const int nr = r + DR[d];
+            const int nc = c + DC[d];
+            if (!m_grid.isWalkable(nr, nc)) continue;
+
+            const int v = nr * cols + nc;
+            if (closed[v] || g[u] + 1 >= g[v]) continue;
+
+            const bool seen = g[v] < (1 << 30);
+            g[v] = g[u] + 1;
+            parent[v] = u;
+
+            const int h = heuristic(v);
+            heap.push_back({ g[v] + m_weight * h, h, v });
+            std::push_heap(heap.begin(), heap.end(), cmp);
+
+            if (!seen && !m_isGoal[v])
+            {
+                Event e;
+                e.kind = Event::Open;
+                e.cell = v;
+                if (!emit(e)) return;
+            }
+        }
+
+        if (m_cancel.load(std::memory_order_relaxed)) return;
+    }
+
+    noPath.value = expanded;
+    finish(noPath);
+}
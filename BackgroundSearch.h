@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include "GridSnapshot.h"
+#include "Path.h"
+#include "SpscRing.h"
+
+// A* on a worker thread, against a GridSnapshot taken when the search starts.
+//
+// The worker never touches Node or Grid. It reports what a step-by-step search
+// would paint (cells opened, closed, the final path, then Found/NoPath) as
+// events in a lock-free SPSC ring, and the UI thread drains a bounded number of
+// them per frame. A full ring makes the worker wait, so the painting never
+// falls arbitrarily far behind the search. cancel() stops and joins the worker
+// and throws away undelivered events, so nothing stale is painted afterwards.
+class BackgroundSearch
+{
+public:
+    struct Event
+    {
+        enum Kind : uint8_t { Open, Closed, Path, Found, NoPath };
+        int cell = -1;    // Found: the goal reached
+        int value = 0;    // Found: path length in steps, NoPath: expanded count
+        Kind kind = Open;
+    };
+
+    BackgroundSearch() : m_events(1 << 16) {}
+    ~BackgroundSearch() { cancel(); }
+
+    BackgroundSearch(const BackgroundSearch&) = delete;
+    BackgroundSearch& operator=(const BackgroundSearch&) = delete;
+
+    // Nearest of the goal cells; weight > 1 runs Weighted A* (f = g + weight*h).
+    // exactH (copied) replaces the Manhattan heuristic with true goal distances.
+    void start(GridSnapshot snapshot, int startCell, const std::vector<int>& goalCells, float weight = 1.0f,
+        const std::vector<int>* exactH = nullptr);
+    void cancel();
+
+    // Consumer side, UI thread only
+    bool poll(Event& e) { return m_events.pop(e); }
+
+    bool active() const { return m_thread.joinable(); }
+    int expandedCount() const { return m_expanded.load(std::memory_order_relaxed); }
+    double workerMs() const { return m_workerMs.load(std::memory_order_relaxed); }
+    size_t backlog() const { return m_events.sizeApprox(); }
+
+    // The route to the goal, Start first. Written by the worker before it sends Found,
+    // so it is complete once the consumer has polled that event; empty until then.
+    const Path& path() const { return m_path; }
+
+private:
+    struct OpenEntry
+    {
+        float f;
+        int h, cell;
+        bool operator>(const OpenEntry& o) const
+        {
+            if (f != o.f) return f > o.f;
+            return h > o.h;
+        }
+    };
+
+    void run();
+    bool emit(const Event& e);   // false once cancelled
+
+    GridSnapshot m_grid;
+    int m_start = -1;
+    std::vector<int> m_goals;
+    std::vector<char> m_isGoal;
+    float m_weight = 1.0f;
+    std::vector<int> m_exactH;   // empty: Manhattan to the nearest goal
+    Path m_path;
+
+    std::thread m_thread;
+    std::atomic<bool> m_cancel{ false };
+    std::atomic<int> m_expanded{ 0 };
+    std::atomic<double> m_workerMs{ 0.0 };
+    SpscRing<Event> m_events;
+};
@@ -0,0 +1,151 @@
+#include "BatchPathfinder.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+void BatchPathfinder::Scratch::prepare(int cellCount)
+{
+    if ((int)g.size() != cellCount)
+    {
+        g.assign(cellCount, 0);
+        parent.assign(cellCount, -1);
+        seen.assign(cellCount, 0);
+        closed.assign(cellCount, 0);
+        stamp = 0;
+    }
+
+    if (++stamp == 0)
+    {
+        std::fill(seen.begin(), seen.end(), 0);
+        std::fill(closed.begin(), closed.end(), 0);
+        stamp = 1;
+    }
+    heap.clear();
+}
+
+void BatchPathfinder::solve(const GridSnapshot& grid, const Query& q, Scratch& s, bool keepPath, Result& out)
+{
+    out = Result();
+    const int n = grid.cellCount();
+    if (q.start < 0 || q.start >= n || q.goal < 0 || q.goal >= n) return;
+    if (!grid.walkableAt(q.start) || !grid.walkableAt(q.goal)) return;
+
+    s.prepare(n);
+
+    const int cols = grid.cols;
+    const int goalRow = q.goal / cols;
+    const int goalCol = q.goal % cols;
+    auto heuristic = [&](int cell)
+        {
+            return std::abs(cell / cols - goalRow) + std::abs(cell % cols - goalCol);
+        };
+
+    std::greater<OpenEntry> cmp;
+    s.g[q.start] = 0;
+    s.parent[q.start] = -1;
+    s.seen[q.start] = s.stamp;
+    s.heap.push_back({ heuristic(q.start), heuristic(q.start), q.start });
+
+    static const int DR[4] = { -1, 1, 0, 0 };
+    static const int DC[4] = { 0, 0, -1, 1 };
+
+    while (!s.heap.empty())
+    {
+        std::pop_heap(s.heap.begin(), s.heap.end(), cmp);
+        const OpenEntry top = s.heap.back();
+        s.heap.pop_back();
+
+        const int u = top.cell;
+        if (s.closed[u] == s.stamp || top.f != s.g[u] + top.h) continue;   // stale entry
+        s.closed[u] = s.stamp;
+        out.expanded++;
+
+        if (u == q.goal)
+        {
+            out.found = true;
+            out.length = s.g[u];
+            if (keepPath)
+            {
+                std::vector<int> cells;
+                for (int v = u; v != -1; v = s.parent[v])
+                    cells.push_back(v);
+                std::reverse(cells.begin(), cells.end());
+                out.path = Path(std::move(cells), cols);
+            }
+            return;
+        }
+
+        const int r = u / cols;
+        const int c = u % cols;
+        for (int d = 0; d < 4; d++)
+        {
+            const int nr = r + DR[d];
+            const int nc = c + DC[d];
+            if (!grid.isWalkable(nr, nc)) continue;
+
+            const int v = nr * cols + nc;
+            if (s.closed[v] == s.stamp) continue;
+
+            const int gv = s.g[u] + 1;
+            if (s.seen[v] == s.stamp && gv >= s.g[v]) continue;
+
+            s.seen[v] = s.stamp;
+            s.g[v] = gv;
+            s.parent[v] = u;
+
+            const int h = heuristic(v);
+            s.heap.push_back({ gv + h, h, v });
+            std::push_heap(s.heap.begin(), s.heap.end(), cmp);
+        }
+    }
+}
+
+std::vector<BatchPathfinder::Result> BatchPathfinder::run(const GridSnapshot& grid,
+    const std::vector<Query>& queries, int threads, bool keepPaths)
+{
+    std::vector<Result> results(queries.size());
+
+    if (threads <= 0)
+        threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, (int)queries.size()));
+    m_lastThreads = threads;
+
+    if ((int)m_scratch.size() < threads)
+        m_scratch.resize(threads);
+
+    // Workers pull small chunks of queries; each writes only its own result slots
+    const int chunk = 16;
+    std::atomic<int> next(0);
+    auto worker = [&](int id)
+        {
+            Scratch& scratch = m_scratch[id];
+            while (true)
+            {
+                const int begin = next.fetch_add(chunk);
+                if (begin >= (int)queries.size()) break;
+
+                const int end = std::min(begin + chunk, (int)queries.size());
+                for (int i = begin; i < end; i++)
+                    solve(grid, queries[i], scratch, keepPaths, results[i]);
+            }
+        };
+
+    if (threads == 1)
+    {
+        worker(0);
+        return results;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (int id = 1; id < threads; id++)
+        pool.emplace_back(worker, id);
+    worker(0);   // the calling thread works too
+
+    for (std::thread& t : pool)
+        t.join();
+
+    return results;
+}
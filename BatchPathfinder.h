@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "GridSnapshot.h"
+#include "Path.h"
+
+// Solves many Start/Goal queries in parallel on a read-only GridSnapshot.
+//
+// Unlike Pathfinder, no search state lives in Node: every worker owns its own
+// scratch arrays (reset in O(1) per query through a stamp), so workers share
+// nothing but the snapshot and an atomic "next query" counter. Results come
+// back in input order.
+class BatchPathfinder
+{
+public:
+    struct Query
+    {
+        int start = -1;   // cell index (row * cols + col)
+        int goal = -1;
+    };
+
+    struct Result
+    {
+        bool found = false;
+        int length = -1;          // steps, -1 if unreachable
+        int expanded = 0;
+        Path path;                // start to goal, when kept
+    };
+
+    // threads <= 0 uses every hardware thread. With keepPaths false only the
+    // length and stats are filled in, which is what scoring jobs need.
+    std::vector<Result> run(const GridSnapshot& grid, const std::vector<Query>& queries,
+        int threads = 0, bool keepPaths = true);
+
+    int lastThreadCount() const { return m_lastThreads; }
+
+private:
+    struct OpenEntry
+    {
+        int f, h, cell;
+        bool operator>(const OpenEntry& o) const
+        {
+            if (f != o.f) return f > o.f;
+            return h > o.h;
+        }
+    };
+
+    // Per-worker search state, kept between runs so repeated batches do not reallocate
+    struct Scratch
+    {
+        std::vector<int> g;
+        std::vector<int> parent;
+        std::vector<uint32_t> seen;
+        std::vector<uint32_t> closed;
+        std::vector<OpenEntry> heap;
+        uint32_t stamp = 0;
+
+        void prepare(int cellCount);
+    };
+
+    static void solve(const GridSnapshot& grid, const Query& q, Scratch& s, bool keepPath, Result& out);
+
+    std::vector<Scratch> m_scratch;
+    int m_lastThreads = 0;
+};
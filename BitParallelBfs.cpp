@@ -0,0 +1,157 @@
+#include "BitParallelBfs.h"
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit; bits != 0
+static int lowestLane(uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, bits);
+    return (int)i;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+void BitParallelBfs::run(const CsrGraph& graph, const int* sources, int count, int maxDepth, const Visit& visit)
+{
+    const int n = graph.nodeCount();
+    if ((int)m_seen.size() != n)
+    {
+        m_seen.assign(n, 0);
+        m_frontier.assign(n, 0);
+        m_next.assign(n, 0);
+    }
+    else
+    {
+        std::fill(m_seen.begin(), m_seen.end(), 0);
+    }
+
+    m_active.clear();
+    m_layers = 0;
+    count = std::min(count, LANES);
+    for (int lane = 0; lane < LANES; lane++)
+        m_ecc[lane] = -1;
+
+    for (int lane = 0; lane < count; lane++)
+    {
+        const int s = sources[lane];
+        if (s < 0 || s >= n) continue;
+
+        const uint64_t bit = uint64_t(1) << lane;
+        if (m_frontier[s] == 0) m_active.push_back(s);
+        m_seen[s] |= bit;
+        m_frontier[s] |= bit;
+        m_ecc[lane] = 0;
+        if (visit) visit(lane, s, 0);
+    }
+
+    for (int depth = 1; !m_active.empty() && (maxDepth < 0 || depth <= maxDepth); depth++)
+    {
+        // Push: every arc carries the bits its source gained last layer
+        m_touched.clear();
+        for (int u : m_active)
+        {
+            const uint64_t f = m_frontier[u];
+            m_frontier[u] = 0;
+            for (int e = graph.firstArc(u); e < graph.lastArc(u); e++)
+            {
+                const int v = graph.target(e);
+                const uint64_t add = f & ~m_seen[v];
+                if (!add) continue;
+                if (!m_next[v]) m_touched.push_back(v);
+                m_next[v] |= add;
+            }
+        }
+        // Commit the layer: the new bits become the next frontier
+        uint64_t layerBits = 0;
+        for (int v : m_touched)
+        {
+            const uint64_t bits = m_next[v];
+            m_next[v] = 0;
+            m_seen[v] |= bits;
+            m_frontier[v] = bits;
+            layerBits |= bits;
+
+            if (visit)
+            {
+                for (uint64_t b = bits; b; b &= b - 1)
+                    visit(lowestLane(b), v, depth);
+            }
+        }
+
+        for (uint64_t b = layerBits; b; b &= b - 1)
+            m_ecc[lowestLane(b)] = depth;
+
+        m_active.swap(m_touched);
+        m_layers = depth;
+    }
+
+    for (int u : m_active)
+        m_frontier[u] = 0;   // cut off by maxDepth
+    m_active.clear();
+}
+
+std::vector<int> BitParallelBfs::tileOrder(const CsrGraph& graph, const std::vector<int>& sources)
+{
+    // A node is in the frontier once per distinct depth at which lanes reach it.
+    // Lanes that start in the same 8x8 tile reach every node within 14 layers of
+    // each other, so a pass costs a few single BFS runs instead of 64.
+    const int cols = std::max(1, graph.cols());
+    auto tileKey = [&](int cell)
+        {
+            const int r = cell / cols;
+            const int c = cell % cols;
+            return ((long long)(r >> 3) * ((cols + 7) >> 3) + (c >> 3)) * 64 + (r & 7) * 8 + (c & 7);
+        };
+
+    std::vector<int> order(sources.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+    std::stable_sort(order.begin(), order.end(),
+        [&](int a, int b) { return tileKey(sources[a]) < tileKey(sources[b]); });
+    return order;
+}
+
+std::vector<int> BitParallelBfs::eccentricities(const CsrGraph& graph, const std::vector<int>& sources)
+{
+    const std::vector<int> order = tileOrder(graph, sources);
+    std::vector<int> ecc(sources.size(), -1);
+    std::vector<int> batch;
+    m_passes = 0;
+    for (size_t first = 0; first < order.size(); first += LANES)
+    {
+        const int count = (int)std::min<size_t>(LANES, order.size() - first);
+        batch.clear();
+        for (int lane = 0; lane < count; lane++)
+            batch.push_back(sources[order[first + lane]]);
+
+        run(graph, batch.data(), count);
+        for (int lane = 0; lane < count; lane++)
+            ecc[order[first + lane]] = m_ecc[lane];
+        m_passes++;
+    }
+    return ecc;
+}
+
+void BitParallelBfs::distances(const CsrGraph& graph, const std::vector<int>& sources,
+    std::vector<std::vector<int>>& out, int inf)
+{
+    const std::vector<int> order = tileOrder(graph, sources);
+    out.assign(sources.size(), std::vector<int>(graph.nodeCount(), inf));
+    std::vector<int> batch;
+    m_passes = 0;
+    for (size_t first = 0; first < order.size(); first += LANES)
+    {
+        const int count = (int)std::min<size_t>(LANES, order.size() - first);
+        batch.clear();
+        for (int lane = 0; lane < count; lane++)
+            batch.push_back(sources[order[first + lane]]);
+
+        run(graph, batch.data(), count, -1,
+            [&](int lane, int node, int depth) { out[order[first + lane]][node] = depth; });
+        m_passes++;
+    }
+}
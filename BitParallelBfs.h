@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "CsrGraph.h"
+
+// BFS from up to 64 sources in one pass over a unit-weight CsrGraph.
+//
+// Every node keeps a 64-bit "reached by" mask, one bit per source (lane). A
+// layer pushes each frontier node's new bits to its arc targets with a bitwise
+// OR, so all 64 searches advance together and share every arc scan. Many
+// sources cost ceil(k / 64) passes instead of k separate BFS runs.
+//
+// Arc weights are ignored: every arc is one step.
+class BitParallelBfs
+{
+public:
+    static constexpr int LANES = 64;
+
+    // Called once per (lane, node) when the node is reached, sources at depth 0
+    using Visit = std::function<void(int lane, int node, int depth)>;
+
+    // Lane i starts at sources[i] (count <= 64). Stops after maxDepth layers (< 0:
+    // no limit). Without a visit callback only the per-lane eccentricities are kept.
+    void run(const CsrGraph& graph, const int* sources, int count, int maxDepth = -1, const Visit& visit = nullptr);
+
+    int eccentricity(int lane) const { return m_ecc[lane]; }   // deepest layer the lane reached
+    uint64_t reachedBy(int node) const { return m_seen[node]; }
+
+    // Any number of sources, 64 per pass; results are in the order of sources.
+    // Sources are batched by 8x8 grid tile so the lanes of a pass stay in step.
+    std::vector<int> eccentricities(const CsrGraph& graph, const std::vector<int>& sources);
+    void distances(const CsrGraph& graph, const std::vector<int>& sources, std::vector<std::vector<int>>& out, int inf);
+
+    int lastPasses() const { return m_passes; }   // passes of the last batched call
+    int lastLayers() const { return m_layers; }   // layers of the last run()
+
+private:
+    static std::vector<int> tileOrder(const CsrGraph& graph, const std::vector<int>& sources);
+
+    std::vector<uint64_t> m_seen;
+    std::vector<uint64_t> m_frontier;
+    std::vector<uint64_t> m_next;
+    std::vector<int> m_active;
+    std::vector<int> m_touched;
+    int m_ecc[LANES] = {};
+    int m_passes = 0;
+    int m_layers = 0;
+};
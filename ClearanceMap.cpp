@@ -0,0 +1,59 @@
+#include "ClearanceMap.h"
+#include <algorithm>
+
+uint8_t ClearanceMap::compute(const std::vector<Node*>& nodes, int r, int c) const
+{
+    if (!nodes[r * m_cols + c]->walkable) return 0;
+
+    // Outside the grid counts as a wall
+    const int right = (c + 1 < m_cols) ? m_values[r * m_cols + c + 1] : 0;
+    const int below = (r + 1 < m_rows) ? m_values[(r + 1) * m_cols + c] : 0;
+    const int diag = (r + 1 < m_rows && c + 1 < m_cols) ? m_values[(r + 1) * m_cols + c + 1] : 0;
+    return (uint8_t)std::min(MAX, 1 + std::min(right, std::min(below, diag)));
+}
+
+void ClearanceMap::build(const Grid& grid)
+{
+    m_rows = grid.rows();
+    m_cols = grid.cols();
+    m_values.assign(m_rows * m_cols, 0);
+
+    const std::vector<Node*>& nodes = grid.getAllNodes();
+    for (int r = m_rows - 1; r >= 0; r--)
+        for (int c = m_cols - 1; c >= 0; c--)
+            m_values[r * m_cols + c] = compute(nodes, r, c);
+}
+
+void ClearanceMap::onWallToggled(const Grid& grid, int r, int c)
+{
+    m_lastUpdated = 0;
+    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
+
+    // Row by row upwards. In each row a cell needs recomputing if it sits over
+    // (or just left of) a changed cell of the row below, or its right neighbour
+    // just changed; everything further left keeps its value.
+    const std::vector<Node*>& nodes = grid.getAllNodes();
+    int lo = c + 1, hi = c;   // changed columns of the row below; seeded so only (r, c) is fed in row r
+    for (int row = r; row >= 0; row--)
+    {
+        int newLo = m_cols, newHi = -1;
+        bool rightChanged = false;
+        for (int col = hi; col >= 0; col--)
+        {
+            if (col < lo - 1 && !rightChanged) break;
+
+            const uint8_t v = compute(nodes, row, col);
+            m_lastUpdated++;
+            rightChanged = (v != m_values[row * m_cols + col]);
+            if (rightChanged)
+            {
+                m_values[row * m_cols + col] = v;
+                newLo = col;
+                newHi = std::max(newHi, col);
+            }
+        }
+        if (newHi < 0) break;
+        lo = newLo;
+        hi = newHi;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Grid.h"
+
+// Per cell: side of the largest wall-free square whose top-left corner is that
+// cell (0 on walls, capped at 255). A k x k agent anchored at its top-left cell
+// fits exactly where value >= k, so a search rejects a cell with one byte
+// compare instead of scanning k*k cells.
+//
+// build() is one bottom-up DP pass: v(r, c) = 1 + min(right, below, diagonal).
+// A toggled wall can only change cells above and to the left of it, and the
+// repair stops as soon as a row no longer changes.
+class ClearanceMap
+{
+public:
+    static constexpr int MAX = 255;
+
+    void build(const Grid& grid);
+    void onWallToggled(const Grid& grid, int r, int c);
+
+    bool empty() const { return m_values.empty(); }
+    const std::vector<uint8_t>& values() const { return m_values; }
+    int at(int cell) const { return m_values[cell]; }
+    bool fits(int cell, int size) const { return m_values[cell] >= size; }
+
+    int lastUpdated() const { return m_lastUpdated; }   // cells recomputed by the last onWallToggled()
+
+private:
+    uint8_t compute(const std::vector<Node*>& nodes, int r, int c) const;
+
+    int m_rows = 0;
+    int m_cols = 0;
+    std::vector<uint8_t> m_values;
+    int m_lastUpdated = 0;
+};
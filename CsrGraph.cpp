@@ -0,0 +1,305 @@
+#include "CsrGraph.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <unordered_set>
+
+static const int DR[4] = { -1, 1, 0, 0 };
+static const int DC[4] = { 0, 0, -1, 1 };
+
+bool CsrGraph::loadLayout(const std::string& path, int rows, int cols, Layout& out, std::string& error)
+{
+    std::ifstream f(path);
+    if (!f.is_open())
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    out = Layout();
+    out.gridMoves = false;
+
+    std::string line;
+    for (int lineNo = 1; std::getline(f, line); lineNo++)
+    {
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream iss(line);
+        std::string cmd;
+        if (!(iss >> cmd)) continue;
+
+        if (cmd == "grid")
+        {
+            out.gridMoves = true;
+            continue;
+        }
+
+        int r1, c1, r2, c2;
+        if ((cmd != "link" && cmd != "arc" && cmd != "cut") || !(iss >> r1 >> c1 >> r2 >> c2))
+        {
+            error = path + ":" + std::to_string(lineNo) + ": expected grid | link/arc/cut r1 c1 r2 c2 [w]";
+            return false;
+        }
+        if (r1 < 0 || r1 >= rows || c1 < 0 || c1 >= cols || r2 < 0 || r2 >= rows || c2 < 0 || c2 >= cols)
+        {
+            error = path + ":" + std::to_string(lineNo) + ": cell outside the " +
+                std::to_string(rows) + "x" + std::to_string(cols) + " grid";
+            return false;
+        }
+
+        int w = 1;
+        int given = 0;
+        if (cmd != "cut" && (iss >> given))
+        {
+            if (given < 0)
+            {
+                error = path + ":" + std::to_string(lineNo) + ": negative weight";
+                return false;
+            }
+            w = given;
+        }
+
+        const Arc a{ r1 * cols + c1, r2 * cols + c2, w };
+        if (cmd == "cut") out.cuts.push_back(a);
+        else out.arcs.push_back(a);
+        if (cmd == "link") out.arcs.push_back({ a.to, a.from, w });
+    }
+    return true;
+}
+
+CsrGraph CsrGraph::fromGrid(const Grid& grid)
+{
+    CsrGraph g;
+    const int n = grid.rows() * grid.cols();
+
+    g.m_cols = grid.cols();
+    g.m_offsets.resize(n + 1);
+    for (int u = 0; u <= n; u++)
+        g.m_offsets[u] = 4 * u;
+    g.m_ends.assign(g.m_offsets.begin(), g.m_offsets.end() - 1);   // all empty until filled
+    g.m_targets.assign(4 * n, -1);
+    g.m_gridSlots = true;
+    for (int u = 0; u < n; u++)
+        g.fillGridSlots(grid, u);
+
+    // Unit moves to 4-neighbours, both ways: nothing to check in finish()
+    g.m_hScale = 1.0f;
+    g.m_symmetric = true;
+    return g;
+}
+
+void CsrGraph::fillGridSlots(const Grid& grid, int cell)
+{
+    const int rows = grid.rows();
+    const int cols = grid.cols();
+    const std::vector<Node*>& nodes = grid.getAllNodes();
+    auto open = [&](int r, int c)
+        {
+            return r >= 0 && r < rows && c >= 0 && c < cols && nodes[r * cols + c]->walkable;
+        };
+
+    const int r = cell / cols;
+    const int c = cell % cols;
+    int end = m_offsets[cell];
+    if (open(r, c))
+    {
+        for (int d = 0; d < 4; d++)
+            if (open(r + DR[d], c + DC[d])) m_targets[end++] = (r + DR[d]) * cols + c + DC[d];
+    }
+    m_arcCount += end - m_ends[cell];
+    m_ends[cell] = end;
+}
+
+bool CsrGraph::onWallToggled(const Grid& grid, int r, int c)
+{
+    if (!m_gridSlots || nodeCount() != grid.rows() * grid.cols()) return false;
+    if (r < 0 || r >= grid.rows() || c < 0 || c >= grid.cols()) return true;
+
+    // Arcs into the cell live in its neighbours' slots
+    fillGridSlots(grid, r * m_cols + c);
+    for (int d = 0; d < 4; d++)
+    {
+        const int nr = r + DR[d];
+        const int nc = c + DC[d];
+        if (nr >= 0 && nr < grid.rows() && nc >= 0 && nc < grid.cols())
+            fillGridSlots(grid, nr * m_cols + nc);
+    }
+    return true;
+}
+
+CsrGraph CsrGraph::fromLayout(const Grid& grid, const Layout& layout)
+{
+    const int rows = grid.rows();
+    const int cols = grid.cols();
+    const std::vector<Node*>& nodes = grid.getAllNodes();
+    auto key = [](int from, int to) { return ((long long)from << 32) | (unsigned)to; };
+
+    std::unordered_set<long long> cut;
+    for (const Arc& a : layout.cuts)
+        cut.insert(key(a.from, a.to));
+
+    std::vector<Arc> arcs;
+    if (layout.gridMoves)
+    {
+        const CsrGraph moves = fromGrid(grid);
+        for (int u = 0; u < moves.nodeCount(); u++)
+            for (int e = moves.firstArc(u); e < moves.lastArc(u); e++)
+                if (!cut.count(key(u, moves.target(e)))) arcs.push_back({ u, moves.target(e), 1 });
+    }
+
+    for (const Arc& a : layout.arcs)
+    {
+        if (!nodes[a.from]->walkable || !nodes[a.to]->walkable) continue;
+        if (cut.count(key(a.from, a.to))) continue;
+        arcs.push_back(a);
+    }
+
+    return fromArcs(rows * cols, cols, arcs);
+}
+
+CsrGraph CsrGraph::fromArcs(int nodeCount, int cols, const std::vector<Arc>& arcs)
+{
+    CsrGraph g;
+    g.m_cols = cols;
+
+    // Counting sort by source node
+    g.m_offsets.assign(nodeCount + 1, 0);
+    for (const Arc& a : arcs)
+        g.m_offsets[a.from + 1]++;
+    for (int u = 0; u < nodeCount; u++)
+        g.m_offsets[u + 1] += g.m_offsets[u];
+
+    const bool weighted = std::any_of(arcs.begin(), arcs.end(), [](const Arc& a) { return a.weight != 1; });
+    g.m_targets.resize(arcs.size());
+    if (weighted) g.m_weights.resize(arcs.size());
+
+    g.m_ends.assign(g.m_offsets.begin() + 1, g.m_offsets.end());
+    g.m_arcCount = (int)arcs.size();
+
+    std::vector<int> fill(g.m_offsets.begin(), g.m_offsets.end() - 1);
+    for (const Arc& a : arcs)
+    {
+        const int slot = fill[a.from]++;
+        g.m_targets[slot] = a.to;
+        if (weighted) g.m_weights[slot] = a.weight;
+    }
+
+    g.finish();
+    return g;
+}
+
+CsrGraph CsrGraph::reversed() const
+{
+    std::vector<Arc> arcs;
+    arcs.reserve(m_arcCount);
+    for (int u = 0; u < nodeCount(); u++)
+        for (int e = firstArc(u); e < lastArc(u); e++)
+            arcs.push_back({ target(e), u, weight(e) });
+    return fromArcs(nodeCount(), m_cols, arcs);
+}
+
+void CsrGraph::finish()
+{
+    m_hScale = 1.0f;
+    m_symmetric = !weighted();
+    for (int u = 0; u < nodeCount(); u++)
+    {
+        for (int e = firstArc(u); e < lastArc(u); e++)
+        {
+            const int v = target(e);
+            const int span = std::abs(u / m_cols - v / m_cols) + std::abs(u % m_cols - v % m_cols);
+            if (span > 0) m_hScale = std::min(m_hScale, (float)weight(e) / (float)span);
+            if (m_symmetric && arcWeight(v, u) != weight(e)) m_symmetric = false;
+        }
+    }
+}
+
+int CsrGraph::arcWeight(int from, int to) const
+{
+    if (from < 0 || from >= nodeCount()) return -1;
+    int best = -1;
+    for (int e = firstArc(from); e < lastArc(from); e++)
+        if (target(e) == to && (best < 0 || weight(e) < best)) best = weight(e);
+    return best;
+}
+
+void CsrGraph::distances(const std::vector<int>& sources, std::vector<int>& dist, int inf,
+    const std::vector<char>* mask) const
+{
+    const int n = nodeCount();
+    dist.assign(n, inf);
+
+    if (!weighted())
+    {
+        // Unit arcs: a plain BFS, the queue is a flat array
+        std::vector<int> queue;
+        queue.reserve(n);
+        for (int s : sources)
+        {
+            if (s < 0 || s >= n || dist[s] == 0) continue;
+            dist[s] = 0;
+            queue.push_back(s);
+        }
+
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            const int u = queue[head];
+            const int du = dist[u] + 1;
+            for (int e = firstArc(u); e < lastArc(u); e++)
+            {
+                const int v = m_targets[e];
+                if (mask && !(*mask)[v]) continue;
+                if (dist[v] > du)
+                {
+                    dist[v] = du;
+                    queue.push_back(v);
+                }
+            }
+        }
+        return;
+    }
+
+    // Weighted arcs: Dijkstra with lazy deletion
+    using Entry = std::pair<int, int>;   // distance, node
+    std::vector<Entry> heap;
+    std::greater<Entry> cmp;
+    for (int s : sources)
+    {
+        if (s < 0 || s >= n || dist[s] == 0) continue;
+        dist[s] = 0;
+        heap.push_back({ 0, s });
+    }
+    std::make_heap(heap.begin(), heap.end(), cmp);
+
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        const Entry top = heap.back();
+        heap.pop_back();
+
+        const int u = top.second;
+        if (top.first != dist[u]) continue;   // stale entry
+
+        for (int e = firstArc(u); e < lastArc(u); e++)
+        {
+            const int v = m_targets[e];
+            if (mask && !(*mask)[v]) continue;
+            const int dv = top.first + m_weights[e];
+            if (dv < dist[v])
+            {
+                dist[v] = dv;
+                heap.push_back({ dv, v });
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+}
+
+size_t CsrGraph::memoryBytes() const
+{
+    return sizeof(CsrGraph) +
+        (m_offsets.capacity() + m_ends.capacity() + m_targets.capacity() + m_weights.capacity()) * sizeof(int);
+}
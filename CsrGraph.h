@@ -0,0 +1,101 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "Grid.h"
+
+// Directed movement graph in compressed sparse row form: the arcs leaving node u
+// are targets[offsets[u] .. ends[u]), optionally with integer weights (all 1 when
+// none are stored). Node ids are grid cells (row * cols + col), so every search,
+// overlay and Node lookup keeps working by index.
+//
+// Producers:
+//  - fromGrid: the 4-neighbour moves between walkable cells. Every cell owns four
+//    slots whether it uses them or not, so a wall toggle rewrites the arcs of the
+//    cell and its neighbours in place (onWallToggled) instead of a rebuild.
+//  - fromLayout: a graph imported from a level's <name>.graph.txt; it may start
+//    from the grid moves, add two-way links, one-way arcs (ledges, teleporters
+//    with any weight) and cut single moves to make them one-way.
+// Consumers scan one contiguous array per node and never special-case any of it.
+class CsrGraph
+{
+public:
+    struct Arc
+    {
+        int from = -1;
+        int to = -1;
+        int weight = 1;
+    };
+
+    // Parsed graph file, one command per line ('#' starts a comment):
+    //   grid                      include the 4-neighbour grid moves
+    //   link r1 c1 r2 c2 [w]      two-way edge
+    //   arc  r1 c1 r2 c2 [w]      one-way edge (ledge, teleporter)
+    //   cut  r1 c1 r2 c2          drop the move r1c1 -> r2c2
+    // Without a "grid" line the file is a pure waypoint graph. A weight of 0 is
+    // accepted, but see heuristicScale(): one such arc turns A* into Dijkstra.
+    struct Layout
+    {
+        bool gridMoves = true;
+        std::vector<Arc> arcs;
+        std::vector<Arc> cuts;
+
+        bool empty() const { return gridMoves && arcs.empty() && cuts.empty(); }
+    };
+
+    static bool loadLayout(const std::string& path, int rows, int cols, Layout& out, std::string& error);
+
+    static CsrGraph fromGrid(const Grid& grid);
+    static CsrGraph fromLayout(const Grid& grid, const Layout& layout);   // arcs touching walls are dropped
+    static CsrGraph fromArcs(int nodeCount, int cols, const std::vector<Arc>& arcs);
+    CsrGraph reversed() const;
+
+    int nodeCount() const { return (int)m_ends.size(); }
+    int arcCount() const { return m_arcCount; }
+    int cols() const { return m_cols; }
+
+    // Arcs of u are the indices firstArc(u) .. lastArc(u) - 1
+    int firstArc(int u) const { return m_offsets[u]; }
+    int lastArc(int u) const { return m_ends[u]; }
+    int target(int arc) const { return m_targets[arc]; }
+    int weight(int arc) const { return m_weights.empty() ? 1 : m_weights[arc]; }
+    bool weighted() const { return !m_weights.empty(); }
+
+    int arcWeight(int from, int to) const;   // -1 if there is no arc from -> to
+
+    // Largest s with s * Manhattan distance never above the true cost: 1 on plain
+    // grids, lower once an arc covers more ground than it costs (teleporters).
+    // A zero-weight arc between two different cells makes it 0: the Manhattan
+    // term drops out and A* on this graph silently becomes Dijkstra (still
+    // optimal, but it expands everything closer than the goal).
+    float heuristicScale() const { return m_hScale; }
+
+    // fromGrid graphs only: the cell at (r, c) changed walkability, so its arcs and
+    // those of its four neighbours are rewritten from the grid, touching five cells.
+    // Returns false, changing nothing, for graphs built any other way.
+    bool onWallToggled(const Grid& grid, int r, int c);
+
+    // Same arcs both ways with unit weights: reversed() would be an identical graph
+    bool symmetric() const { return m_symmetric; }
+
+    // Shortest distances from the nearest source (BFS, Dijkstra when weighted).
+    // Nodes with mask[node] == 0 are never entered; unreached nodes get inf.
+    void distances(const std::vector<int>& sources, std::vector<int>& dist, int inf,
+        const std::vector<char>* mask = nullptr) const;
+
+    size_t memoryBytes() const;
+
+private:
+    void finish();   // fills m_hScale and m_symmetric
+    void fillGridSlots(const Grid& grid, int cell);
+
+    std::vector<int> m_offsets;   // nodeCount + 1 entries
+    std::vector<int> m_ends;      // per node; offsets[u + 1] unless the graph has fixed slots
+    std::vector<int> m_targets;
+    std::vector<int> m_weights;   // empty: every arc costs 1
+    int m_cols = 0;
+    int m_arcCount = 0;
+    float m_hScale = 1.0f;
+    bool m_symmetric = true;
+    bool m_gridSlots = false;     // fromGrid: four slots per cell at offsets[u] = 4u
+};
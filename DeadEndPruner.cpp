@@ -0,0 +1,602 @@
+#include "DeadEndPruner.h"
+#include <queue>
+#include <algorithm>
+
+static const int DR[4] = { -1, 1, 0, 0 };
+static const int DC[4] = { 0, 0, -1, 1 };
+
+void DeadEndPruner::clear()
+{
+    m_rows = 0;
+    m_cols = 0;
+    m_block.clear();
+    m_artBlocks.clear();
+    m_blockArts.clear();
+    m_blockSeed.clear();
+    m_blockSize.clear();
+    m_blockAlive.clear();
+    m_freeBlocks.clear();
+    m_liveBlocks = 0;
+    m_disc.clear();
+    m_low.clear();
+    m_mark.clear();
+    m_stamp = 0;
+    m_dirs.clear();
+}
+
+int DeadEndPruner::newBlock(int seed)
+{
+    int b;
+    if (!m_freeBlocks.empty())
+    {
+        b = m_freeBlocks.back();
+        m_freeBlocks.pop_back();
+        m_blockAlive[b] = 1;
+    }
+    else
+    {
+        b = (int)m_blockArts.size();
+        m_blockArts.emplace_back();
+        m_blockSeed.push_back(-1);
+        m_blockSize.push_back(0);
+        m_blockAlive.push_back(1);
+    }
+    m_blockSeed[b] = seed;
+    m_blockSize[b] = 0;
+    m_liveBlocks++;
+    return b;
+}
+
+void DeadEndPruner::killBlock(int b)
+{
+    if (b < 0 || !m_blockAlive[b]) return;
+    m_blockAlive[b] = 0;
+    m_blockArts[b].clear();
+    m_blockSize[b] = 0;
+    m_freeBlocks.push_back(b);
+    m_liveBlocks--;
+}
+
+void DeadEndPruner::assign(int cell, int b)
+{
+    m_blockSize[b]++;
+    if (m_block[cell] < 0)
+    {
+        m_block[cell] = b;
+        return;
+    }
+
+    // A cell in a second block is an articulation point
+    std::vector<int>& blocks = m_artBlocks[cell];
+    if (blocks.empty())
+    {
+        blocks.push_back(m_block[cell]);
+        m_blockArts[m_block[cell]].push_back(cell);
+    }
+    blocks.push_back(b);
+    m_blockArts[b].push_back(cell);
+}
+
+bool DeadEndPruner::inBlock(int cell, int b) const
+{
+    if (m_block[cell] == b) return true;
+    auto it = m_artBlocks.find(cell);
+    return it != m_artBlocks.end() && std::find(it->second.begin(), it->second.end(), b) != it->second.end();
+}
+
+void DeadEndPruner::blocksOf(int cell, std::vector<int>& out) const
+{
+    out.clear();
+    auto it = m_artBlocks.find(cell);
+    if (it != m_artBlocks.end()) out = it->second;
+    else if (m_block[cell] >= 0) out.push_back(m_block[cell]);
+}
+
+int DeadEndPruner::neighbor(const Grid& grid, int cell, int dir) const
+{
+    const Node* nb = grid.getNode(cell / m_cols + DR[dir], cell % m_cols + DC[dir]);
+    if (!nb || !nb->walkable) return -1;
+    return nb->row * m_cols + nb->col;
+}
+
+unsigned DeadEndPruner::nextStamp()
+{
+    if (++m_stamp == 0)
+    {
+        std::fill(m_mark.begin(), m_mark.end(), 0u);
+        m_stamp = 1;
+    }
+    return m_stamp;
+}
+
+void DeadEndPruner::blockCells(int b, std::vector<int>& out)
+{
+    // Flood by membership only: a cell just turned into a wall still belongs to its blocks
+    const unsigned stamp = nextStamp();
+    const size_t first = out.size();
+    const int seed = m_blockSeed[b];
+    m_mark[seed] = stamp;
+    out.push_back(seed);
+
+    for (size_t i = first; i < out.size(); i++)
+    {
+        const int cell = out[i];
+        const int r = cell / m_cols;
+        const int c = cell % m_cols;
+        for (int d = 0; d < 4; d++)
+        {
+            const int nr = r + DR[d];
+            const int nc = c + DC[d];
+            if (nr < 0 || nr >= m_rows || nc < 0 || nc >= m_cols) continue;
+            const int v = nr * m_cols + nc;
+            if (m_mark[v] == stamp || !inBlock(v, b)) continue;
+            m_mark[v] = stamp;
+            out.push_back(v);
+        }
+    }
+}
+
+void DeadEndPruner::build(const Grid& grid)
+{
+    clear();
+    m_rows = grid.rows();
+    m_cols = grid.cols();
+
+    const int n = m_rows * m_cols;
+    m_block.assign(n, -1);
+    m_disc.assign(n, -1);
+    m_low.assign(n, 0);
+    m_mark.assign(n, 0);
+    m_dirs.assign(n, 0);
+
+    for (int i = 0; i < n; i++)
+    {
+        const Node* node = grid.getNode(i / m_cols, i % m_cols);
+        if (node && node->walkable && m_disc[i] < 0)
+            decomposeComponent(grid, i, false);
+    }
+}
+
+void DeadEndPruner::decomposeComponent(const Grid& grid, int root, bool restricted)
+{
+    int timer = 0;
+
+    // Restricted: only the moves update() allowed in m_dirs (the cells being decomposed again)
+    auto next = [&](int cell, int dir)
+        {
+            if (!restricted) return neighbor(grid, cell, dir);
+            if (!((m_dirs[cell] >> dir) & 1)) return -1;
+            return cell + DR[dir] * m_cols + DC[dir];
+        };
+
+    struct Frame { int cell; int parent; int next; };
+    std::vector<Frame> dfs;
+    std::vector<int> stack;
+
+    m_disc[root] = m_low[root] = timer++;
+    stack.push_back(root);
+    dfs.push_back({ root, -1, 0 });
+
+    // Iterative Tarjan: a block is closed off whenever a child cannot reach above its parent
+    while (!dfs.empty())
+    {
+        Frame& f = dfs.back();
+        const int u = f.cell;
+
+        if (f.next < 4)
+        {
+            const int v = next(u, f.next++);
+            if (v < 0) continue;
+
+            if (m_disc[v] < 0)
+            {
+                m_disc[v] = m_low[v] = timer++;
+                stack.push_back(v);
+                dfs.push_back({ v, u, 0 });
+            }
+            else if (v != f.parent)
+            {
+                m_low[u] = std::min(m_low[u], m_disc[v]);
+            }
+            continue;
+        }
+
+        dfs.pop_back();
+        if (dfs.empty()) break;
+
+        const int p = dfs.back().cell;
+        m_low[p] = std::min(m_low[p], m_low[u]);
+
+        if (m_low[u] >= m_disc[p])
+        {
+            const int b = newBlock(u);
+            while (true)
+            {
+                const int w = stack.back();
+                stack.pop_back();
+                assign(w, b);
+                if (w == u) break;
+            }
+            assign(p, b);
+        }
+    }
+
+    // Isolated cell (and in no block kept from before): a block on its own
+    if (m_block[root] < 0)
+        assign(root, newBlock(root));
+}
+
+void DeadEndPruner::treePaths(const std::vector<int>& cells, std::vector<int>& group, std::vector<std::vector<int>>& pathBlocks)
+{
+    // One BFS over the block-cut tree per cell, advanced in turns. Two searches that
+    // touch the same tree node join their groups, and the two routes back to their
+    // cells are the tree path between them. A group whose searches have all run out
+    // has seen its whole component, so the search stops once at most one group can
+    // still grow.
+    const int k = (int)cells.size();
+    const int artBase = (int)m_blockArts.size();
+    auto treeNode = [&](int cell) { return isArt(cell) ? artBase + cell : m_block[cell]; };
+
+    group.resize(k);
+    for (int i = 0; i < k; i++) group[i] = i;
+    auto find = [&](int i) { while (group[i] != i) i = group[i]; return i; };
+
+    std::vector<std::unordered_map<int, int>> prev(k);
+    std::vector<std::vector<int>> open(k);
+    std::vector<size_t> head(k, 0);
+    std::vector<std::pair<int, int>> found;   // (search, block) on a joining path
+
+    auto trace = [&](int i, int t)
+        {
+            for (int v = t; v != -1; v = prev[i].at(v))
+                if (v < artBase) found.push_back({ i, v });
+        };
+    auto touch = [&](int i, int t)
+        {
+            for (int j = 0; j < k; j++)
+            {
+                if (j == i || find(j) == find(i) || !prev[j].count(t)) continue;
+                trace(i, t);
+                trace(j, t);
+                group[find(j)] = find(i);
+            }
+        };
+
+    for (int i = 0; i < k; i++)
+    {
+        const int t = treeNode(cells[i]);
+        prev[i][t] = -1;
+        open[i].push_back(t);
+        touch(i, t);
+    }
+
+    while (true)
+    {
+        int groups = 0, growing = 0;
+        for (int i = 0; i < k; i++)
+        {
+            if (find(i) != i) continue;
+            groups++;
+            for (int j = 0; j < k; j++)
+                if (find(j) == i && head[j] < open[j].size()) { growing++; break; }
+        }
+        if (groups <= 1 || growing <= 1) break;
+
+        for (int i = 0; i < k; i++)
+        {
+            if (head[i] >= open[i].size()) continue;
+            const int v = open[i][head[i]++];
+            const std::vector<int>& adj = (v < artBase) ? m_blockArts[v] : m_artBlocks.at(v - artBase);
+            for (int u : adj)
+            {
+                const int t = (v < artBase) ? artBase + u : u;
+                if (prev[i].count(t)) continue;
+                prev[i][t] = v;
+                open[i].push_back(t);
+                touch(i, t);
+            }
+        }
+    }
+
+    for (int i = 0; i < k; i++) group[i] = find(i);
+    pathBlocks.assign(k, {});
+    for (const auto& f : found)
+        pathBlocks[find(f.first)].push_back(f.second);
+    for (std::vector<int>& blocks : pathBlocks)
+    {
+        std::sort(blocks.begin(), blocks.end());
+        blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+    }
+}
+
+void DeadEndPruner::mergeInto(int survivor, int other)
+{
+    std::vector<int> cells;
+    blockCells(other, cells);
+
+    for (int cell : cells)
+    {
+        auto it = m_artBlocks.find(cell);
+        if (it == m_artBlocks.end())
+        {
+            m_block[cell] = survivor;
+            m_blockSize[survivor]++;
+            continue;
+        }
+
+        std::vector<int>& blocks = it->second;
+        const bool shared = std::find(blocks.begin(), blocks.end(), survivor) != blocks.end();
+        blocks.erase(std::find(blocks.begin(), blocks.end(), other));
+        if (!shared)
+        {
+            blocks.push_back(survivor);
+            m_blockArts[survivor].push_back(cell);
+            m_blockSize[survivor]++;
+        }
+        if (m_block[cell] == other) m_block[cell] = blocks.front();
+
+        // Both its blocks became one: no longer an articulation point
+        if (blocks.size() == 1)
+        {
+            std::vector<int>& arts = m_blockArts[survivor];
+            arts.erase(std::find(arts.begin(), arts.end(), cell));
+            m_block[cell] = survivor;
+            m_artBlocks.erase(it);
+        }
+    }
+    killBlock(other);
+}
+
+void DeadEndPruner::addCell(const Grid& grid, int x)
+{
+    std::vector<int> around;
+    for (int d = 0; d < 4; d++)
+    {
+        const int v = neighbor(grid, x, d);
+        if (v >= 0) around.push_back(v);
+    }
+    if (around.empty())
+    {
+        assign(x, newBlock(x));
+        return;
+    }
+
+    std::vector<int> group;
+    std::vector<std::vector<int>> pathBlocks;
+    treePaths(around, group, pathBlocks);
+
+    for (int i = 0; i < (int)around.size(); i++)
+    {
+        if (group[i] != i) continue;
+
+        // A neighbour with no other neighbour in its component: the new edge is a bridge
+        // (an isolated neighbour's one-cell block simply grows into it)
+        const std::vector<int>& blocks = pathBlocks[i];
+        if (blocks.empty())
+        {
+            const int nb = around[i];
+            if (!isArt(nb) && m_blockSize[m_block[nb]] == 1)
+            {
+                assign(x, m_block[nb]);
+                continue;
+            }
+            const int b = newBlock(x);
+            assign(x, b);
+            assign(nb, b);
+            continue;
+        }
+
+        // Otherwise x closes a cycle through every block on the paths: they become one
+        const int survivor = *std::max_element(blocks.begin(), blocks.end(),
+            [&](int a, int b) { return m_blockSize[a] < m_blockSize[b]; });
+        for (int b : blocks)
+            if (b != survivor) mergeInto(survivor, b);
+        assign(x, survivor);
+    }
+}
+
+bool DeadEndPruner::removeCell(const Grid& grid, int x)
+{
+    // All eight cells around x walkable: its neighbours stay joined by a ring that no
+    // single cell can cut, so its block loses x and stays biconnected
+    const int r = x / m_cols;
+    const int c = x % m_cols;
+    bool ring = !isArt(x) && r > 0 && r < m_rows - 1 && c > 0 && c < m_cols - 1;
+    for (int dr = -1; dr <= 1 && ring; dr++)
+        for (int dc = -1; dc <= 1 && ring; dc++)
+            if (dr || dc) ring = grid.getNode(r + dr, c + dc)->walkable;
+    if (ring)
+    {
+        const int b = m_block[x];
+        m_block[x] = -1;
+        m_blockSize[b]--;
+        if (m_blockSeed[b] == x) m_blockSeed[b] = x + 1;
+        return true;
+    }
+
+    // Only the blocks x was in can split; every other block stays biconnected
+    std::vector<int> affected;
+    blocksOf(x, affected);
+
+    // Decomposing most of the map again costs as much as a rebuild; leave that to the caller
+    int size = 0;
+    for (int b : affected) size += m_blockSize[b];
+    if (size > std::max(REPAIR_MIN, m_rows * m_cols / 8)) return false;
+    std::sort(affected.begin(), affected.end());
+    auto isAffected = [&](int b) { return std::binary_search(affected.begin(), affected.end(), b); };
+
+    std::vector<int> cells;
+    for (int b : affected)
+        blockCells(b, cells);
+
+    const unsigned inRegion = nextStamp();
+    std::vector<int> region;
+    for (int cell : cells)
+    {
+        if (cell == x || m_mark[cell] == inRegion) continue;
+        m_mark[cell] = inRegion;
+        region.push_back(cell);
+    }
+
+    // Moves inside those blocks only: an edge between two of these cells that belongs
+    // to a kept block (a bridge between two articulation cells) stays where it is
+    std::vector<int> blocks;
+    for (int u : region)
+    {
+        blocksOf(u, blocks);
+        uint8_t dirs = 0;
+        for (int d = 0; d < 4; d++)
+        {
+            const int v = neighbor(grid, u, d);
+            if (v < 0 || m_mark[v] != inRegion) continue;
+            for (int b : blocks)
+                if (isAffected(b) && inBlock(v, b)) { dirs |= (uint8_t)(1u << d); break; }
+        }
+        m_dirs[u] = dirs;
+    }
+
+    // Forget the affected blocks; each cell keeps its other blocks
+    std::vector<int> kept;
+    for (int u : region)
+    {
+        blocksOf(u, blocks);
+        kept.clear();
+        for (int b : blocks)
+            if (!isAffected(b)) kept.push_back(b);
+
+        auto it = m_artBlocks.find(u);
+        if (it != m_artBlocks.end())
+        {
+            for (int b : kept)
+            {
+                std::vector<int>& arts = m_blockArts[b];
+                arts.erase(std::find(arts.begin(), arts.end(), u));
+            }
+            m_artBlocks.erase(it);
+        }
+        m_block[u] = -1;
+        m_disc[u] = -1;
+        for (int b : kept)
+        {
+            m_blockSize[b]--;
+            assign(u, b);
+        }
+    }
+    m_artBlocks.erase(x);
+    m_block[x] = -1;
+    for (int b : affected)
+        killBlock(b);
+
+    for (int u : region)
+        if (m_disc[u] < 0)
+            decomposeComponent(grid, u, true);
+    return true;
+}
+
+bool DeadEndPruner::update(const Grid& grid, int r, int c)
+{
+    if (empty() || grid.rows() != m_rows || grid.cols() != m_cols) return false;
+
+    const Node* center = grid.getNode(r, c);
+    if (!center) return true;
+
+    const int x = r * m_cols + c;
+    if (center->walkable == (m_block[x] >= 0)) return true;
+
+    if (!center->walkable) return removeCell(grid, x);
+    addCell(grid, x);
+    return true;
+}
+
+bool DeadEndPruner::buildMask(const Node* start, const Node* goal, std::vector<char>& mask)
+{
+    return buildMask(start, std::vector<const Node*>{ goal }, mask);
+}
+
+bool DeadEndPruner::buildMask(const Node* start, const std::vector<const Node*>& goals, std::vector<char>& mask)
+{
+    const int n = m_rows * m_cols;
+    mask.assign(n, 0);
+
+    m_lastWalkable = 0;
+    for (int i = 0; i < n; i++)
+        if (m_block[i] >= 0) m_lastWalkable++;
+    m_lastPruned = m_lastWalkable;
+
+    if (!start) return false;
+
+    const int s = start->row * m_cols + start->col;
+    if (m_block[s] < 0) return false;
+
+    // Block-cut tree nodes: blocks keep their id, articulation cells are shifted past them
+    const int artBase = (int)m_blockArts.size();
+    auto treeNode = [&](int cell) { return isArt(cell) ? artBase + cell : m_block[cell]; };
+
+    const int from = treeNode(s);
+
+    // The tree is small; one BFS from the Start covers every goal
+    std::unordered_map<int, int> prev;
+    std::queue<int> q;
+    prev[from] = -1;
+    q.push(from);
+
+    while (!q.empty())
+    {
+        const int v = q.front();
+        q.pop();
+
+        const std::vector<int>& next = (v < artBase) ? m_blockArts[v] : m_artBlocks.at(v - artBase);
+        for (int u : next)
+        {
+            const int key = (v < artBase) ? artBase + u : u;
+            if (prev.count(key)) continue;
+            prev[key] = v;
+            q.push(key);
+        }
+    }
+
+    // Goals outside the Start's component (not in its tree) can never be reached
+    std::vector<int> targets;
+    for (const Node* goal : goals)
+    {
+        if (!goal) continue;
+        const int g = goal->row * m_cols + goal->col;
+        if (m_block[g] >= 0 && prev.count(treeNode(g))) targets.push_back(g);
+    }
+    if (targets.empty()) return false;
+
+    // Keep the union of the Start->goal tree paths
+    std::vector<char> keepBlock(m_blockArts.size(), 0);
+    for (int g : targets)
+    {
+        for (int v = treeNode(g); v != -1; v = prev.at(v))
+        {
+            if (v < artBase)
+            {
+                if (keepBlock[v]) break;   // the rest of this path is shared with an earlier goal
+                keepBlock[v] = 1;
+            }
+        }
+    }
+
+    int kept = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (m_block[i] < 0) continue;
+
+        bool keep = keepBlock[m_block[i]] != 0;
+        if (!keep && isArt(i))
+        {
+            for (int b : m_artBlocks[i])
+                if (keepBlock[b]) { keep = true; break; }
+        }
+        if (keep) { mask[i] = 1; kept++; }
+    }
+
+    if (!mask[s]) { mask[s] = 1; kept++; }
+    for (int g : targets)
+        if (!mask[g]) { mask[g] = 1; kept++; }
+
+    m_lastPruned = m_lastWalkable - kept;
+    return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Grid.h"
+
+// Marks dead ends and "swamps": walkable regions that hang off the rest of the
+// map through a single cell. Such a region can only be on an optimal path if the
+// Start or the Goal lies inside it.
+//
+// Preprocessing splits every connected component into biconnected blocks
+// (Tarjan). A query keeps only the blocks on the block-cut-tree path between the
+// Start and the Goal; everything else is pruned.
+class DeadEndPruner
+{
+public:
+    void build(const Grid& grid);
+    void clear();
+
+    // Incremental update after the wall at (r, c) was toggled; every block the edit
+    // cannot change is kept. A new wall decomposes again only the blocks it sat in,
+    // and not even those when all eight cells around it are walkable. A removed wall
+    // needs no decomposition: the blocks on the block-cut-tree paths between the
+    // cells it now connects merge into one (the smaller ones are relabelled into the
+    // largest), and a neighbour with no other path gets a bridge.
+    // Returns false, changing nothing, when a new wall sits in blocks holding more
+    // than an eighth of the grid: the caller should rebuild before the next query.
+    bool update(const Grid& grid, int r, int c);
+
+    // Fills mask (rows*cols, 1 = may be on an optimal path). Returns false if the
+    // Start and the Goal are not connected.
+    bool buildMask(const Node* start, const Node* goal, std::vector<char>& mask);
+
+    // Several goals: keeps the union of the Start->goal block paths. Returns false
+    // if no goal is connected to the Start.
+    bool buildMask(const Node* start, const std::vector<const Node*>& goals, std::vector<char>& mask);
+
+    bool empty() const { return m_block.empty(); }
+    int lastPruned() const { return m_lastPruned; }      // walkable cells pruned by the last mask
+    int lastWalkable() const { return m_lastWalkable; }  // walkable cells in the grid at that time
+    int blockCount() const { return m_liveBlocks; }
+
+private:
+    void decomposeComponent(const Grid& grid, int root, bool restricted);
+    int newBlock(int seed);
+    void killBlock(int b);
+    void assign(int cell, int b);
+
+    bool isArt(int cell) const { return m_artBlocks.count(cell) != 0; }
+    bool inBlock(int cell, int b) const;
+    void blocksOf(int cell, std::vector<int>& out) const;
+    void blockCells(int b, std::vector<int>& out);   // appends the cells of block b
+    void mergeInto(int survivor, int other);
+    int neighbor(const Grid& grid, int cell, int dir) const;
+    unsigned nextStamp();
+
+    // Groups the cells by connectivity (group[i] = index of the group's first cell) and
+    // lists the blocks on the block-cut-tree paths that join each group, per group
+    void treePaths(const std::vector<int>& cells, std::vector<int>& group, std::vector<std::vector<int>>& pathBlocks);
+
+    void addCell(const Grid& grid, int x);
+    bool removeCell(const Grid& grid, int x);
+
+    static constexpr int REPAIR_MIN = 4096;   // blocks this small are always repaired in place
+
+    int m_rows = 0;
+    int m_cols = 0;
+
+    std::vector<int> m_block;       // block per cell (for articulation cells: any one of them), -1 for walls
+    std::unordered_map<int, std::vector<int>> m_artBlocks; // articulation cell -> its blocks
+
+    std::vector<std::vector<int>> m_blockArts; // block -> articulation cells in it
+    std::vector<int> m_blockSeed;              // block -> one of its cells
+    std::vector<int> m_blockSize;              // block -> cells in it (articulation cells count in each)
+    std::vector<char> m_blockAlive;
+    std::vector<int> m_freeBlocks;
+    int m_liveBlocks = 0;
+
+    // Tarjan scratch, sized rows*cols
+    std::vector<int> m_disc;
+    std::vector<int> m_low;
+
+    // update() scratch, sized rows*cols and reused: stamped marks instead of clearing
+    std::vector<unsigned> m_mark;
+    unsigned m_stamp = 0;
+    std::vector<uint8_t> m_dirs;    // restricted decomposition: allowed moves per cell (bit per direction)
+
+    int m_lastPruned = 0;
+    int m_lastWalkable = 0;
+};
@@ -0,0 +1,244 @@
+#include "EditJournal.h"
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+
+// --- Encoding ---
+
+void EditJournal::putVarint(std::vector<uint8_t>& out, uint32_t v)
+{
+    while (v >= 0x80)
+    {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+uint32_t EditJournal::getVarint(const std::vector<uint8_t>& in, size_t& pos)
+{
+    uint32_t v = 0;
+    for (int shift = 0; pos < in.size(); shift += 7)
+    {
+        const uint8_t b = in[pos++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+    }
+    return v;
+}
+
+void EditJournal::encodeCells(const std::vector<int>& cells, Entry& e)
+{
+    std::vector<uint8_t> runs;
+    int prevEnd = 0;   // one past the previous run
+    for (size_t i = 0; i < cells.size(); )
+    {
+        size_t j = i + 1;
+        while (j < cells.size() && cells[j] == cells[j - 1] + 1) j++;
+
+        putVarint(runs, (uint32_t)(cells[i] - prevEnd));
+        putVarint(runs, (uint32_t)(j - i - 1));
+        prevEnd = cells[j - 1] + 1;
+        i = j;
+    }
+
+    // Scattered flips: one bit per cell between the first and the last is smaller
+    std::vector<uint8_t> bits;
+    bool useBits = false;
+    if (!cells.empty())
+    {
+        const int base = cells.front();
+        putVarint(bits, (uint32_t)base);
+        const size_t header = bits.size();
+        const size_t span = (size_t)(cells.back() - base) / 8 + 1;
+        useBits = header + span < runs.size();
+        if (useBits)
+        {
+            bits.resize(header + span, 0);
+            for (int c : cells)
+                bits[header + (c - base) / 8] |= (uint8_t)(1u << ((c - base) % 8));
+        }
+    }
+
+    e.bitmap = useBits;
+    e.data = e.bitmap ? std::move(bits) : std::move(runs);
+    e.cellBytes = (uint32_t)e.data.size();
+    e.cellCount = (uint32_t)cells.size();
+}
+
+void EditJournal::decodeCells(const Entry& e, std::vector<int>& cells)
+{
+    size_t pos = 0;
+    if (e.bitmap)
+    {
+        const int base = (int)getVarint(e.data, pos);
+        for (int i = 0; pos < e.cellBytes; pos++, i += 8)
+            for (int b = 0; b < 8; b++)
+                if (e.data[pos] & (1u << b)) cells.push_back(base + i + b);
+        return;
+    }
+
+    int prevEnd = 0;
+    while (pos < e.cellBytes)
+    {
+        const int first = prevEnd + (int)getVarint(e.data, pos);
+        const int length = (int)getVarint(e.data, pos) + 1;
+        for (int k = 0; k < length; k++)
+            cells.push_back(first + k);
+        prevEnd = first + length;
+    }
+}
+
+void EditJournal::encodeMarkers(const Markers& before, const Markers& after, std::vector<uint8_t>& out)
+{
+    for (const Markers* m : { &before, &after })
+    {
+        putVarint(out, (uint32_t)(m->start + 1));   // -1 (no Start) becomes 0
+        putVarint(out, (uint32_t)m->goals.size());
+        for (int g : m->goals)
+            putVarint(out, (uint32_t)g);
+    }
+}
+
+void EditJournal::decodeMarkers(const Entry& e, Markers& before, Markers& after)
+{
+    size_t pos = e.cellBytes;
+    for (Markers* m : { &before, &after })
+    {
+        m->start = (int)getVarint(e.data, pos) - 1;
+        m->goals.resize(getVarint(e.data, pos));
+        for (int& g : m->goals)
+            g = (int)getVarint(e.data, pos);
+    }
+}
+
+EditJournal::Step EditJournal::decode(const Entry& e)
+{
+    Step s;
+    s.flipped.reserve(e.cellCount);
+    decodeCells(e, s.flipped);
+    s.hasMarkers = e.hasMarkers();
+    if (s.hasMarkers) decodeMarkers(e, s.before, s.after);
+    s.label = e.label;
+    return s;
+}
+
+// --- Log ---
+
+void EditJournal::setBudget(size_t bytes)
+{
+    m_budget = bytes;
+    enforceBudget();
+}
+
+void EditJournal::clear()
+{
+    m_undo.clear();
+    m_redo.clear();
+    m_bytes = 0;
+}
+
+void EditJournal::record(const std::vector<int>& flipped, const Markers* before, const Markers* after, const char* label)
+{
+    const bool moved = before && after && *before != *after;
+    if (flipped.empty() && !moved) return;
+
+    for (const Entry& e : m_redo)
+        m_bytes -= e.bytes();
+    m_redo.clear();
+
+    Entry e;
+    encodeCells(flipped, e);
+    if (moved) encodeMarkers(*before, *after, e.data);
+    e.data.shrink_to_fit();
+    e.label = label;
+
+    m_bytes += e.bytes();
+    m_undo.push_back(std::move(e));
+    enforceBudget();
+}
+
+bool EditJournal::undo(Step& out)
+{
+    if (m_undo.empty()) return false;
+    out = decode(m_undo.back());
+    m_redo.push_back(std::move(m_undo.back()));
+    m_undo.pop_back();
+    return true;
+}
+
+bool EditJournal::redo(Step& out)
+{
+    if (m_redo.empty()) return false;
+    out = decode(m_redo.back());
+    m_undo.push_back(std::move(m_redo.back()));
+    m_redo.pop_back();
+    return true;
+}
+
+EditJournal::Entry EditJournal::merge(const Entry& older, const Entry& newer)
+{
+    // Flipping a cell twice leaves it as it was: the merged flips are the symmetric difference
+    std::vector<int> a, b, both;
+    decodeCells(older, a);
+    decodeCells(newer, b);
+    std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(both));
+
+    Entry m;
+    encodeCells(both, m);
+    m.label = "merged edits";
+
+    // Markers go from the older step's 'before' to the newer step's 'after'
+    if (older.hasMarkers() || newer.hasMarkers())
+    {
+        Markers b0, a0, b1, a1;
+        if (older.hasMarkers()) decodeMarkers(older, b0, a0);
+        if (newer.hasMarkers()) decodeMarkers(newer, b1, a1);
+        const Markers& before = older.hasMarkers() ? b0 : b1;
+        const Markers& after = newer.hasMarkers() ? a1 : a0;
+        if (before != after) encodeMarkers(before, after, m.data);
+    }
+    m.data.shrink_to_fit();
+    return m;
+}
+
+void EditJournal::enforceBudget()
+{
+    // Redo steps go first, farthest from the present first: they are only there
+    // after an undo, and a budget lowered then must not cost the undo history
+    while (m_bytes > m_budget && !m_redo.empty())
+    {
+        m_bytes -= m_redo.front().bytes();
+        m_redo.erase(m_redo.begin());
+        m_drops++;
+    }
+
+    while (m_bytes > m_budget && !m_undo.empty())
+    {
+        if (m_undo.size() >= 3)   // never fold into the newest step, it is what Ctrl+Z is expected to undo
+        {
+            // Worth it only when the flips largely cancel (a wall drawn and erased again);
+            // disjoint steps would just pile up into one ever larger oldest step
+            Entry merged = merge(m_undo[0], m_undo[1]);
+            const size_t pair = m_undo[0].bytes() + m_undo[1].bytes();
+            if (merged.bytes() <= std::max(m_undo[0].bytes(), m_undo[1].bytes()))
+            {
+                m_bytes -= pair;
+                m_undo.pop_front();
+                if (merged.data.empty())
+                    m_undo.pop_front();   // the two cancel out completely
+                else
+                {
+                    m_bytes += merged.bytes();
+                    m_undo.front() = std::move(merged);
+                }
+                m_merges++;
+                continue;
+            }
+        }
+
+        m_bytes -= m_undo.front().bytes();
+        m_undo.pop_front();
+        m_drops++;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+
+// Undo/redo log of grid edits, stored as deltas instead of grid copies.
+//
+// Every wall edit is a set of cells whose walkable flag flipped, so the same
+// delta both undoes and redoes it. The sorted cells are stored as runs
+// (varint gap from the previous run, varint length): a single toggle takes
+// two bytes, and Clear Walls one run per stretch of walls. Where runs would be
+// bigger (Random Walls flips scattered cells), a bitmap from the first to the
+// last flipped cell is kept instead. A Start/Goal move keeps the cells before
+// and after.
+//
+// The log stays under a byte budget. When a new step (or a lower budget) pushes
+// it over, redo steps are dropped first; then the two oldest steps are merged
+// if their flips mostly cancel out (the merge is no bigger than the larger of
+// the two), otherwise the oldest step is dropped.
+class EditJournal
+{
+public:
+    struct Markers
+    {
+        int start = -1;
+        std::vector<int> goals;
+
+        bool operator==(const Markers& o) const { return start == o.start && goals == o.goals; }
+        bool operator!=(const Markers& o) const { return !(*this == o); }
+    };
+
+    // A decoded step, handed to the caller to apply
+    struct Step
+    {
+        std::vector<int> flipped;   // ascending cell indices
+        bool hasMarkers = false;
+        Markers before;
+        Markers after;
+        const char* label = "";
+    };
+
+    static constexpr size_t DEFAULT_BUDGET = 4u << 20;
+
+    void setBudget(size_t bytes);
+    size_t budget() const { return m_budget; }
+    size_t bytes() const { return m_bytes; }
+
+    void clear();
+
+    // flipped must be ascending. Either part may be empty; a step with neither is ignored.
+    // Clears the redo side.
+    void record(const std::vector<int>& flipped, const Markers* before, const Markers* after, const char* label);
+
+    // Newest step to undo (apply flips, restore 'before') or to redo (apply flips, restore 'after')
+    bool undo(Step& out);
+    bool redo(Step& out);
+
+    size_t undoCount() const { return m_undo.size(); }
+    size_t redoCount() const { return m_redo.size(); }
+    int merges() const { return m_merges; }
+    int drops() const { return m_drops; }
+
+private:
+    struct Entry
+    {
+        std::vector<uint8_t> data;   // flipped cells (runs or bitmap), then the markers if any
+        uint32_t cellBytes = 0;      // data[0, cellBytes) holds the flipped cells
+        uint32_t cellCount = 0;
+        const char* label = "";
+        bool bitmap = false;
+
+        bool hasMarkers() const { return data.size() > cellBytes; }
+        size_t bytes() const { return sizeof(Entry) + data.size(); }
+    };
+
+    static void putVarint(std::vector<uint8_t>& out, uint32_t v);
+    static uint32_t getVarint(const std::vector<uint8_t>& in, size_t& pos);
+    static void encodeCells(const std::vector<int>& cells, Entry& e);   // writes the start of e.data
+    static void decodeCells(const Entry& e, std::vector<int>& cells);
+    static void encodeMarkers(const Markers& before, const Markers& after, std::vector<uint8_t>& out);
+    static void decodeMarkers(const Entry& e, Markers& before, Markers& after);
+
+    static Step decode(const Entry& e);
+    static Entry merge(const Entry& older, const Entry& newer);
+    void enforceBudget();
+
+    std::deque<Entry> m_undo;     // oldest first
+    std::vector<Entry> m_redo;    // next to redo last
+    size_t m_budget = DEFAULT_BUDGET;
+    size_t m_bytes = 0;
+    int m_merges = 0;
+    int m_drops = 0;
+};
@@ -0,0 +1,246 @@
+#include "FlowField.h"
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+static const int DR[4] = { -1, 1, 0, 0 };
+static const int DC[4] = { 0, 0, -1, 1 };
+
+void FlowField::clear()
+{
+    m_grid = nullptr;
+    m_goals.clear();
+    m_walkable.clear();
+    m_isGoal.clear();
+    m_dist.clear();
+    m_dir.clear();
+    m_lost.clear();
+    m_lastRepair = 0;
+}
+
+void FlowField::build(const Grid& grid, const std::vector<Node*>& goals, const std::vector<int>& dist)
+{
+    m_grid = &grid;
+    m_rows = grid.rows();
+    m_cols = grid.cols();
+    m_goals = goals;
+
+    const int n = m_rows * m_cols;
+    m_walkable.assign(n, 0);
+    for (const Node* node : grid.getAllNodes())
+        if (node && node->walkable) m_walkable[node->row * m_cols + node->col] = 1;
+
+    m_isGoal.assign(n, 0);
+    for (const Node* g : goals)
+        if (g) m_isGoal[g->row * m_cols + g->col] = 1;
+
+    m_dist.resize(n);
+    for (int i = 0; i < n; i++)
+        m_dist[i] = std::min(dist[i], UNREACHABLE);
+
+    m_lost.assign(n, 0);
+    m_dir.assign(n, NONE);
+    for (int i = 0; i < n; i++)
+        refreshDirection(i);
+
+    m_lastRepair = n;
+}
+
+int FlowField::next(int cell) const
+{
+    const uint8_t d = m_dir[cell];
+    if (d == NONE) return -1;
+    return (cell / m_cols + DR[d]) * m_cols + (cell % m_cols + DC[d]);
+}
+
+void FlowField::refreshDirection(int cell)
+{
+    m_dir[cell] = NONE;
+    if (!walkable(cell) || m_isGoal[cell] || m_dist[cell] >= UNREACHABLE) return;
+
+    const int r = cell / m_cols;
+    const int c = cell % m_cols;
+    int best = m_dist[cell];
+    for (int d = 0; d < 4; d++)
+    {
+        const int nr = r + DR[d];
+        const int nc = c + DC[d];
+        if (nr < 0 || nr >= m_rows || nc < 0 || nc >= m_cols) continue;
+
+        const int v = nr * m_cols + nc;
+        if (walkable(v) && m_dist[v] < best)
+        {
+            best = m_dist[v];
+            m_dir[cell] = (uint8_t)d;
+        }
+    }
+}
+
+void FlowField::refreshAround(int cell)
+{
+    refreshDirection(cell);
+    const int r = cell / m_cols;
+    const int c = cell % m_cols;
+    for (int d = 0; d < 4; d++)
+    {
+        const int nr = r + DR[d];
+        const int nc = c + DC[d];
+        if (nr >= 0 && nr < m_rows && nc >= 0 && nc < m_cols)
+            refreshDirection(nr * m_cols + nc);
+    }
+}
+
+void FlowField::onWallToggled(int r, int c)
+{
+    if (!m_grid || empty()) return;
+
+    const Node* node = m_grid->getNode(r, c);
+    if (!node) return;
+
+    const int x = r * m_cols + c;
+    if ((m_walkable[x] != 0) == node->walkable) return;   // nothing changed
+
+    m_lastRepair = 0;
+    m_walkable[x] = node->walkable ? 1 : 0;
+    if (node->walkable) lower(x);
+    else raise(x);
+}
+
+void FlowField::raise(int x)
+{
+    // Cells that hung off x in the BFS tree lose their support. Collect every
+    // cell left without a neighbour one step closer to a goal...
+    std::vector<int> lost;
+    std::vector<char>& isLost = m_lost;   // all zero between repairs
+    std::queue<int> q;
+
+    const int oldX = m_dist[x];
+    m_dist[x] = UNREACHABLE;
+    refreshAround(x);
+    if (oldX >= UNREACHABLE) return;
+
+    auto supported = [&](int v)
+        {
+            if (m_isGoal[v]) return true;
+            const int r = v / m_cols, c = v % m_cols;
+            for (int d = 0; d < 4; d++)
+            {
+                const int nr = r + DR[d], nc = c + DC[d];
+                if (nr < 0 || nr >= m_rows || nc < 0 || nc >= m_cols) continue;
+                const int u = nr * m_cols + nc;
+                if (walkable(u) && !isLost[u] && m_dist[u] == m_dist[v] - 1) return true;
+            }
+            return false;
+        };
+
+    auto pushChildren = [&](int u, int du)
+        {
+            const int r = u / m_cols, c = u % m_cols;
+            for (int d = 0; d < 4; d++)
+            {
+                const int nr = r + DR[d], nc = c + DC[d];
+                if (nr < 0 || nr >= m_rows || nc < 0 || nc >= m_cols) continue;
+                const int v = nr * m_cols + nc;
+                if (walkable(v) && !isLost[v] && m_dist[v] == du + 1) q.push(v);
+            }
+        };
+
+    pushChildren(x, oldX);
+    while (!q.empty())
+    {
+        const int v = q.front();
+        q.pop();
+        if (isLost[v] || supported(v)) continue;
+
+        isLost[v] = 1;
+        lost.push_back(v);
+        pushChildren(v, m_dist[v]);
+    }
+
+    // ...then re-seed them from their intact neighbours and relax in distance order
+    using Entry = std::pair<int, int>;   // (dist, cell)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+    for (int v : lost)
+    {
+        m_dist[v] = UNREACHABLE;
+        const int r = v / m_cols, c = v % m_cols;
+        for (int d = 0; d < 4; d++)
+        {
+            const int nr = r + DR[d], nc = c + DC[d];
+            if (nr < 0 || nr >= m_rows || nc < 0 || nc >= m_cols) continue;
+            const int u = nr * m_cols + nc;
+            if (walkable(u) && !isLost[u] && m_dist[u] < UNREACHABLE)
+                m_dist[v] = std::min(m_dist[v], m_dist[u] + 1);
+        }
+        if (m_dist[v] < UNREACHABLE) pq.push({ m_dist[v], v });
+    }
+
+    while (!pq.empty())
+    {
+        const Entry e = pq.top();
+        pq.pop();
+        if (e.first != m_dist[e.second]) continue;
+
+        const int r = e.second / m_cols, c = e.second % m_cols;
+        for (int d = 0; d < 4; d++)
+        {
+            const int nr = r + DR[d], nc = c + DC[d];
+            if (nr < 0 || nr >= m_rows || nc < 0 || nc >= m_cols) continue;
+            const int v = nr * m_cols + nc;
+            if (isLost[v] && m_dist[v] > e.first + 1)
+            {
+                m_dist[v] = e.first + 1;
+                pq.push({ m_dist[v], v });
+            }
+        }
+    }
+
+    for (int v : lost)
+    {
+        refreshAround(v);
+        isLost[v] = 0;
+    }
+    m_lastRepair = (int)lost.size() + 1;
+}
+
+void FlowField::lower(int x)
+{
+    // The reopened cell takes its best neighbour, then improvements spread BFS-style
+    const int r = x / m_cols, c = x % m_cols;
+    m_dist[x] = m_isGoal[x] ? 0 : UNREACHABLE;
+    for (int d = 0; d < 4; d++)
+    {
+        const int nr = r + DR[d], nc = c + DC[d];
+        if (nr < 0 || nr >= m_rows || nc < 0 || nc >= m_cols) continue;
+        const int u = nr * m_cols + nc;
+        if (walkable(u) && m_dist[u] < UNREACHABLE)
+            m_dist[x] = std::min(m_dist[x], m_dist[u] + 1);
+    }
+
+    refreshAround(x);
+    m_lastRepair = 1;
+    if (m_dist[x] >= UNREACHABLE) return;
+
+    std::queue<int> q;
+    q.push(x);
+    while (!q.empty())
+    {
+        const int u = q.front();
+        q.pop();
+
+        const int ur = u / m_cols, uc = u % m_cols;
+        for (int d = 0; d < 4; d++)
+        {
+            const int nr = ur + DR[d], nc = uc + DC[d];
+            if (nr < 0 || nr >= m_rows || nc < 0 || nc >= m_cols) continue;
+            const int v = nr * m_cols + nc;
+            if (walkable(v) && m_dist[v] > m_dist[u] + 1)
+            {
+                m_dist[v] = m_dist[u] + 1;
+                refreshAround(v);
+                m_lastRepair++;
+                q.push(v);
+            }
+        }
+    }
+}
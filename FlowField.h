@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Grid.h"
+
+// Goal-rooted direction field for crowds: one BFS from the goal(s) gives every
+// cell its distance, and each cell points at its lowest-distance neighbour.
+// Any number of agents then follow the field by lookup alone. The distances
+// are also the exact goal distance field used by scoring and by A*'s perfect
+// heuristic (GlobalState::distGoal), so one cached BFS serves all three.
+//
+// Wall toggles are repaired locally: only cells whose distance actually changes
+// (and their neighbours' directions) are touched.
+class FlowField
+{
+public:
+    static constexpr int UNREACHABLE = 1 << 28;
+    static constexpr uint8_t NONE = 255;   // goal cell, wall, or cut off from every goal
+
+    // dist is a goal-rooted BFS (see GlobalState::computeBfsDistances); values
+    // at or above UNREACHABLE mean "no path".
+    void build(const Grid& grid, const std::vector<Node*>& goals, const std::vector<int>& dist);
+    void clear();
+
+    // Local repair after the wall at (r, c) was toggled
+    void onWallToggled(int r, int c);
+
+    bool empty() const { return m_dist.empty(); }
+    bool sameGoals(const std::vector<Node*>& goals) const { return goals == m_goals; }
+
+    int distance(int cell) const { return m_dist[cell]; }
+    const std::vector<int>& distances() const { return m_dist; }
+    uint8_t direction(int cell) const { return m_dir[cell]; }
+
+    // Cell the field points to from cell, or -1 if there is nowhere to go
+    int next(int cell) const;
+
+    int lastRepairCount() const { return m_lastRepair; }   // cells re-evaluated by the last repair
+
+private:
+    bool walkable(int cell) const { return m_walkable[cell] != 0; }
+    void refreshDirection(int cell);
+    void refreshAround(int cell);
+    void raise(int cell);   // wall added: distances can only grow
+    void lower(int cell);   // wall removed: distances can only shrink
+
+    const Grid* m_grid = nullptr;
+    int m_rows = 0;
+    int m_cols = 0;
+
+    std::vector<Node*> m_goals;
+    std::vector<char> m_walkable;   // mirror of the grid when the field was last updated
+    std::vector<char> m_isGoal;
+    std::vector<int> m_dist;
+    std::vector<uint8_t> m_dir;     // 0 up, 1 down, 2 left, 3 right, NONE
+    std::vector<char> m_lost;       // raise() scratch
+    int m_lastRepair = 0;
+};
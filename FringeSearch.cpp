@@ -0,0 +1,160 @@
+#include "FringeSearch.h"
+#include <algorithm>
+#include <cmath>
+
+// Direction codes shared by the 2-bit parent field: up, down, left, right
+static const int DR[4] = { -1, 1, 0, 0 };
+static const int DC[4] = { 0, 0, -1, 1 };
+
+uint32_t FringeSearch::heuristic(int cell) const
+{
+    return (uint32_t)(std::abs(cell / m_cols - m_goalCell / m_cols) + std::abs(cell % m_cols - m_goalCell % m_cols));
+}
+
+int FringeSearch::parentDir(int cell) const
+{
+    return (m_dirs[cell >> 2] >> ((cell & 3) * 2)) & 3;
+}
+
+void FringeSearch::setParentDir(int cell, int dir)
+{
+    const int shift = (cell & 3) * 2;
+    m_dirs[cell >> 2] = (uint8_t)((m_dirs[cell >> 2] & ~(3 << shift)) | (dir << shift));
+}
+
+void FringeSearch::trackMemory()
+{
+    const size_t bytes = m_g.size() * sizeof(uint32_t) + m_dirs.size() +
+        (m_now.size() + m_later.size()) * sizeof(Entry);
+    m_peakBytes = std::max(m_peakBytes, bytes);
+}
+
+void FringeSearch::start(Grid& grid, Node* start, Node* goal)
+{
+    cancel();
+    if (!start || !goal) return;
+
+    m_grid = &grid;
+    m_cols = grid.cols();
+    m_startCell = start->row * m_cols + start->col;
+    m_goalCell = goal->row * m_cols + goal->col;
+
+    // Wall-free bounding box: the L-shaped path is optimal and needs no g values at all
+    if (!grid.anyWall(start->row, start->col, goal->row, goal->col))
+    {
+        m_path = Path::lShape(m_startCell, m_goalCell, m_cols);
+        m_emptyBox = true;
+        return;
+    }
+
+    const int n = grid.rows() * m_cols;
+    m_g.assign(n, UNSEEN);
+    m_dirs.assign((n + 3) / 4, 0);
+
+    m_g[m_startCell] = 0;
+    m_now.push_back({ m_startCell, 0 });
+    m_fLimit = heuristic(m_startCell);
+    m_fMin = UNSEEN;
+
+    trackMemory();
+}
+
+Pathfinder::Result FringeSearch::step()
+{
+    if (m_startCell < 0 || m_goalCell < 0) return Pathfinder::Result::NoPath;
+    if (m_emptyBox) return Pathfinder::Result::Found;
+
+    while (true)
+    {
+        if (m_now.empty())
+        {
+            // Threshold sweep finished: retry the deferred nodes with the next f limit
+            if (m_later.empty()) return Pathfinder::Result::NoPath;
+
+            m_now.swap(m_later);
+            std::reverse(m_now.begin(), m_now.end());
+            m_fLimit = m_fMin;
+            m_fMin = UNSEEN;
+            m_iterations++;
+        }
+
+        const Entry e = m_now.back();
+        m_now.pop_back();
+
+        // Superseded by a cheaper copy that was pushed later
+        if (e.g != m_g[e.cell]) continue;
+
+        const uint32_t f = e.g + heuristic(e.cell);
+        if (f > m_fLimit)
+        {
+            m_fMin = std::min(m_fMin, f);
+            m_later.push_back(e);
+            continue;
+        }
+
+        if (e.cell == m_goalCell)
+        {
+            buildPath();
+            return Pathfinder::Result::Found;
+        }
+
+        m_expanded++;
+        const int r = e.cell / m_cols;
+        const int c = e.cell % m_cols;
+
+        Node* cur = m_grid->getNode(r, c);
+        if (e.cell != m_startCell) cur->state = NodeVizState::Closed;
+
+        for (int d = 3; d >= 0; d--)
+        {
+            Node* nb = m_grid->getNode(r + DR[d], c + DC[d]);
+            if (!nb || !nb->walkable) continue;
+
+            const int s = nb->row * m_cols + nb->col;
+            const uint32_t gs = e.g + 1;
+            if (gs >= m_g[s]) continue;
+
+            m_g[s] = gs;
+            setParentDir(s, d ^ 1); // opposite direction points back to the parent
+            m_now.push_back({ s, gs });
+
+            if (s != m_startCell && s != m_goalCell)
+                nb->state = NodeVizState::Open;
+        }
+
+        trackMemory();
+        return Pathfinder::Result::Running;
+    }
+}
+
+void FringeSearch::buildPath()
+{
+    std::vector<int> cells;
+    for (int cell = m_goalCell; ; )
+    {
+        cells.push_back(cell);
+        if (cell == m_startCell) break;
+
+        const int d = parentDir(cell);
+        cell = (cell / m_cols + DR[d]) * m_cols + (cell % m_cols + DC[d]);
+    }
+    std::reverse(cells.begin(), cells.end());
+    m_path = Path(std::move(cells), m_cols);
+}
+
+void FringeSearch::cancel()
+{
+    m_startCell = -1;
+    m_goalCell = -1;
+    m_g.clear();
+    m_g.shrink_to_fit();
+    m_dirs.clear();
+    m_dirs.shrink_to_fit();
+    m_now.clear();
+    m_later.clear();
+    m_expanded = 0;
+    m_iterations = 0;
+    m_peakBytes = 0;
+    m_emptyBox = false;
+    m_path.clear();
+}
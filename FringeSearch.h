@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Grid.h"
+#include "Pathfinder.h"
+
+// Memory-lean alternative to Pathfinder (Fringe Search, Bjornsson et al.).
+//
+// No open list or per-node records: the search keeps one 32-bit g value and a
+// 2-bit parent direction per cell, plus two flat "now/later" fringe lists that
+// are swept IDA*-style with a rising f threshold. Nothing is written into Node
+// except the visualisation state.
+class FringeSearch
+{
+public:
+    void start(Grid& grid, Node* start, Node* goal);
+    Pathfinder::Result step();
+    void cancel();
+
+    int expandedCount() const { return m_expanded; }
+    int iterations() const { return m_iterations; }
+    bool usedEmptyBox() const { return m_emptyBox; }   // no walls between Start and Goal: no search ran
+
+    // Largest amount of search state held at once (g + directions + fringe lists)
+    size_t peakMemoryBytes() const { return m_peakBytes; }
+
+    // Start to Goal after step() returned Found
+    const Path& path() const { return m_path; }
+
+private:
+    struct Entry { int cell; uint32_t g; };
+
+    static constexpr uint32_t UNSEEN = 0xFFFFFFFFu;
+
+    uint32_t heuristic(int cell) const;
+    int parentDir(int cell) const;
+    void setParentDir(int cell, int dir);
+    void trackMemory();
+    void buildPath();
+
+    Grid* m_grid = nullptr;
+    int m_cols = 0;
+    int m_startCell = -1;
+    int m_goalCell = -1;
+
+    std::vector<uint32_t> m_g;     // UNSEEN until generated
+    std::vector<uint8_t> m_dirs;   // 2 bits per cell: direction to the parent
+
+    std::vector<Entry> m_now;      // processed depth-first (stack)
+    std::vector<Entry> m_later;    // deferred to the next threshold
+    uint32_t m_fLimit = 0;
+    uint32_t m_fMin = UNSEEN;
+
+    int m_expanded = 0;
+    int m_iterations = 0;
+    size_t m_peakBytes = 0;
+    bool m_emptyBox = false;
+    Path m_path;
+};
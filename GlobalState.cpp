@@ -31,8 +31,8 @@ void GlobalState::init()
     graphics::preloadBitmaps("assets/ui");
 
     m_levelsEasy = { "assets/levels/easy_01.txt",   "assets/levels/easy_02.txt" };
-    m_levelsMedium = { "assets/levels/medium_01.txt", "assets/levels/medium_02.txt" };
-    m_levelsHard = { "assets/levels/hard_01.txt",   "assets/levels/hard_02.txt" };
+    m_levelsMedium = { "assets/levels/medium_01.txt", "assets/levels/medium_02.txt", "assets/levels/medium_03.txt" };
+    m_levelsHard = { "assets/levels/hard_01.txt",   "assets/levels/hard_02.txt",   "assets/levels/hard_03.txt" };
 
     // Layout + grid
     setupLayout();
@@ -41,6 +41,7 @@ void GlobalState::init()
     // Default start/goal
     m_start = nodeAt(m_rows / 2, 2);
     m_goal = nodeAt(m_rows / 2, m_cols - 3);
+    m_goals.assign(1, m_goal);
 
     if (m_start) m_start->state = NodeVizState::Start;
     if (m_goal)  m_goal->state = NodeVizState::Goal;
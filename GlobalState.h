@@ -5,7 +5,25 @@
 #include "Node.h"
 #include "UIWidget.h"
 #include "Grid.h"
+#include "GridStore.h"
 #include "Pathfinder.h"
+#include "RoomGraph.h"
+#include "DeadEndPruner.h"
+#include "RectSymmetry.h"
+#include "FringeSearch.h"
+#include "BatchPathfinder.h"
+#include "ParallelAStar.h"
+#include "FlowField.h"
+#include "MultiAgentPlanner.h"
+#include "PatrolReplanner.h"
+#include "PathService.h"
+#include "BackgroundSearch.h"
+#include "NearOptimalRoutes.h"
+#include "CsrGraph.h"
+#include "BitParallelBfs.h"
+#include "ThetaStar.h"
+#include "ClearanceMap.h"
+#include "EditJournal.h"
 #include <unordered_set>
 #include <queue>
 #include <limits>
@@ -36,12 +54,15 @@ private:
 
     // Dynamically allocated nodes
     Grid m_grid;
+    GridStore m_gridStore;          // copy-on-write wall/state planes for worker snapshots; outlives every holder below
+    GridSnapshot gridSnapshot();    // O(1), Start/Goal marks brought up to date first
 
     // Polymorphic collection
     std::vector<VisualAsset*> m_drawables;
 
     Node* m_start = nullptr;
     Node* m_goal = nullptr;
+    std::vector<Node*> m_goals;   // every goal of the level; m_goal is the first one
 
     std::string m_status;
 
@@ -49,31 +70,228 @@ private:
 	// --- Node access helpers ---
     Node* nodeAt(int r, int c) const;
     Node* nodeFromMouse(float mx, float my) const;
+    bool isGoal(const Node* n) const;
+    void setSingleGoal(Node* n);   // replaces the whole goal set with n
 
 	// --- Grid management ---
     void buildGridGraph();
     void clearWallsAndPathKeepEndpoints();
+
+	// --- Undo/redo of wall and Start/Goal edits (delta log, bounded in bytes) ---
+    EditJournal m_journal;
+    EditJournal::Markers currentMarkers() const;
+    void setMarkers(const EditJournal::Markers& m);
+    void undoEdit();
+    void redoEdit();
+    void applyJournalStep(const EditJournal::Step& step, bool undo);
     void resetSearchVisuals();
     void setupUI();
     void setupLayout();
+    void onWallsChanged(Node* changed = nullptr);  // call after any wall edit (nullptr = bulk edit)
 
 	// --- A* Pathfinder ---
     Pathfinder m_pf;
     bool runAStar(); // returns true if found path
     void startAStar();
-    bool stepAStar();
+    bool stepAStar(int maxExpansions = 1, double maxMicros = 0.0);   // true once the search ended
     void cancelAStar();
     enum class AStarRunState { Idle, Running, Paused, Found, NoPath };
     AStarRunState m_aState = AStarRunState::Idle;
 
+	// --- Instant A* on a worker thread (grid snapshot + event ring) ---
+    BackgroundSearch m_bgSearch;
+    int m_bgDrainPerFrame = 20000;   // events painted per frame at most
+    float m_bgUiMs = 0.0f;           // wall time since the worker started, seen by the UI
+    int m_bgFrames = 0;
+    bool startBackgroundAStar();     // false: the selected engine runs synchronously instead
+    void drainBackgroundAStar(float dtMs);
+    // A step-by-step search not finished yet, or a worker still streaming: edits must cancel either
+    bool searchInProgress() const
+    {
+        return m_aState == AStarRunState::Running || m_aState == AStarRunState::Paused || m_bgSearch.active();
+    }
+
+	// --- Search engine selection ---
+    enum class SearchEngine { AStar, Rooms, RSR, Fringe, Weighted, Anytime, Theta };
+    SearchEngine m_engine = SearchEngine::AStar;
+    std::string engineName() const;
+    SearchEngine activeEngine() const;   // single-goal engines fall back to A* on multi-goal levels
+    std::string searchStats() const;
+    int engineExpanded() const;
+    void startEngine();                  // prepares + starts the selected engine
+    Pathfinder::Result stepEngine();
+    Pathfinder::Progress stepEngineFor(int maxExpansions, double maxMicros);
+    Path enginePath() const;             // result of the active engine's last search
+    void markEnginePath();               // paints the found path, keeps it in m_foundPath
+    Path m_foundPath;
+
+	// --- Weighted / anytime (ARA*) quality-latency knob ---
+    float m_epsilon = 2.0f;          // weight for Weighted A*, starting epsilon for ARA*
+    float m_deadlineMs = 5.0f;       // instant ARA* keeps tightening until this budget is spent
+    float m_publishedBound = 1.0f;   // proven suboptimality bound of the path on screen
+
+	// --- Perfect heuristic from the cached goal distance field ---
+    bool m_exactHeuristic = false;
+    void toggleExactHeuristic();
+
+	// --- Movement graph (CSR) the searches, BFS and scoring walk ---
+    CsrGraph m_graph;                 // grid moves, or the level's imported graph
+    CsrGraph m_graphReverse;          // arcs flipped, for distances to the goals (only when m_graph is not symmetric)
+    CsrGraph::Layout m_layout;        // the level's <name>.graph.txt; empty: plain 4-neighbour grid
+    bool m_graphDirty = true;
+    std::vector<int> m_layoutGoalDist;        // distGoal() while a layout is loaded
+    std::vector<Node*> m_layoutGoalDistFor;   // goals it was computed for
+    bool m_layoutGoalDirty = true;
+
+    const CsrGraph& ensureGraph();
+    bool loadGraphLayout(const std::string& levelPath);   // false (and m_status) on a broken file
+    void computeGoalDistances(std::vector<int>& dist);    // to the nearest goal along the arcs
+    void drawGraphLayout() const;
+
+	// --- Clearance map: agents larger than one cell ---
+    ClearanceMap m_clearance;    // rebuilt after bulk edits, repaired around single toggles
+    int m_agentSize = 1;         // k: the agent covers k x k cells, anchored at its top-left cell
+    void agentAnchors(const Node* cell, std::vector<Node*>& out) const;
+    void cycleAgentSize();
+    void drawAgentFootprint() const;
+
+	// --- Level analytics (64 BFS sources per pass) ---
+    BitParallelBfs m_multiBfs;
+    void runLevelAnalytics();
+
+	// --- Wall-removal impact map ---
+    // Per cell: steps the shortest Start->Goal route would save if that wall were
+    // removed (0 for walkable cells and walls that do not matter). When Start and
+    // Goal are cut off, walls that would reconnect them hold IMPACT_CONNECTS.
+    static constexpr int IMPACT_CONNECTS = 1 << 29;
+    std::vector<int> m_wallImpact;
+    bool m_impactOn = false;
+    bool m_impactDirty = true;
+    int m_impactStart = -1;             // Start cell the map was built for
+    std::vector<Node*> m_impactGoals;   // goals it was built for
+    int m_impactMax = 0;                // largest finite saving
+    int m_impactWalls = 0;              // walls whose removal shortens or reconnects the route
+    double m_impactMicros = 0.0;
+
+    bool computeWallImpact();
+    void toggleWallImpact();
+    void drawWallImpactOverlay() const;
+
+	// --- Room/portal decomposition ---
+    RoomGraph m_rooms;
+    bool m_roomsDirty = true;
+    std::vector<char> m_roomMask;   // cells of the rooms on the planned route
+    void rebuildRooms();
+    bool planRoomRoute();
+    void drawRoomOverlay() const;
+
+	// --- Dead-end / swamp pruning ---
+    DeadEndPruner m_pruner;
+    bool m_prunerDirty = true;
+    bool m_pruneDeadEnds = true;
+    std::vector<char> m_pruneMask;  // 1 = may lie on an optimal Start->Goal path
+    bool buildPruneMask();
+
+	// --- Rectangular symmetry reduction ---
+    RectSymmetry m_rsr;
+    bool m_rsrDirty = true;
+
+	// --- Memory-lean Fringe Search ---
+    FringeSearch m_fringe;
+
+	// --- Any-angle Lazy Theta* (line of sight on packed wall bitboards) ---
+    ThetaStar m_theta;
+    bool m_thetaDirty = true;
+    void drawAnyAnglePath() const;
+
+	// --- Parallel batch queries (offline jobs) ---
+    BatchPathfinder m_batch;
+    void runBatchBenchmark(int queryCount = 2000);   // random pairs, 1 thread vs all threads
+    ParallelAStar m_hda;
+    void runParallelAStarBenchmark();                 // Start to Goal: serial A* vs HDA* on 1, 2, 4... threads
+
+	// --- Flow field + crowd of agents heading for the goal(s) ---
+    struct CrowdAgent
+    {
+        int cell = -1;      // cell the agent is leaving
+        int next = -1;      // cell it is walking into (-1: waiting)
+        float t = 0.0f;     // progress from cell to next, 0..1
+    };
+    FlowField m_flow;
+    bool m_flowDirty = true;
+    bool m_crowdOn = false;
+    std::vector<CrowdAgent> m_agents;
+    float m_agentSpeed = 6.0f;   // cells per second
+    int m_crowdArrivals = 0;
+
+    void ensureFlowField();
+    void toggleCrowd(int agentCount = 300);
+    void spawnAgent(CrowdAgent& a, const std::vector<int>& freeCells);
+    void updateCrowd(float dtMs);
+    void drawCrowd() const;
+
+	// --- Multi-agent mode (space-time cooperative A* / CBS) ---
+    enum class MapfMode { Off, Cooperative, CBS };
+    MapfMode m_mapfMode = MapfMode::Off;
+    MultiAgentPlanner m_mapf;
+    std::vector<MultiAgentPlanner::Agent> m_mapfAgents;
+    bool m_mapfDirty = false;
+    float m_mapfClock = 0.0f;    // animation time in timesteps
+
+    void cycleMapfMode();
+    void pickMapfAgents(int count);
+    void planMapf();
+    void updateMapf(float dtMs);
+    void drawMapf() const;
+
+	// --- Moving-wall patrols + budgeted replanning runner ---
+    PatrolReplanner m_patrol;
+    bool m_patrolOn = false;
+    float m_patrolTickAccumMs = 0.0f;
+    float m_patrolTickMs = 150.0f;      // patrols and runner move one cell per tick
+    int m_patrolBudget = 64;            // search expansions per frame
+    double m_patrolFrameUs = 0.0;       // cost of the last frame's patrol update
+    int m_patrolRuns = 0;
+
+    void togglePatrols();
+    void updatePatrols(float dtMs);
+    void drawPatrols() const;
+
+	// --- Prioritized path requests served within a per-frame budget ---
+    PathService m_paths;
+    bool m_pathsOn = false;
+    bool m_pathsStale = false;                    // walls changed since the main request
+    double m_pathBudgetUs = 2000.0;               // search time per frame
+    float m_pathSubmitAccumMs = 0.0f;
+    PathService::Handle m_pathMain = -1;          // Start -> Goal, high priority
+    std::vector<PathService::Handle> m_pathRequests;   // background load, oldest first
+    static constexpr int PATH_REQUESTS_KEPT = 120;      // older ones are released to the service
+
+    void togglePathRequests();
+    void submitBackgroundRequests(int count);
+    void updatePathRequests(float dtMs);
+    void drawPathRequests() const;
+
 	// --- A* step timing ---
-    float m_stepDelayMs = 35.0f;
+    float m_stepDelayMs = 35.0f;        // 0: as many expansions as m_stepBudgetUs allows
     float m_stepAccumMs = 0.0f;
+    double m_stepBudgetUs = 4000.0;     // search time per frame at high speeds
 
 	// --- Key edge detection ---
     bool m_prevSpace = false;
     bool m_prevR = false;
     bool m_prevD = false;
+    bool m_prevB = false;
+    bool m_prevF = false;
+    bool m_prevM = false;
+    bool m_prevP = false;
+    bool m_prevQ = false;
+    bool m_prevI = false;
+    bool m_prevH = false;
+    bool m_prevW = false;
+    bool m_prevL = false;
+    bool m_prevZ = false;
+    bool m_prevY = false;
     
 	// --- UI ---
     std::vector<UIWidget*> m_ui;
@@ -96,7 +314,7 @@ private:
     std::vector<Node*> m_playerPath;  // player path nodes (includes start, ends at goal if reached)
 
     void clearPlayerPath();
-    bool isAdjacent(const Node* a, const Node* b) const;
+    bool isAdjacent(const Node* a, const Node* b);   // one arc of the movement graph
     bool appendPlayerPath(Node* n);
     void beginPlayerDrawing();
     void endPlayerDrawing();
@@ -123,7 +341,6 @@ private:
 
     // --- Scoring / shortest distance data ---
     std::vector<int>  m_distStart;
-    std::vector<int>  m_distGoal;
     std::vector<char> m_onShortest;     // 1 if cell is on any shortest path
 
     int   m_shortestSteps = -1;         // shortest steps Start->Goal (BFS)
@@ -134,10 +351,21 @@ private:
     int   m_score = 0;                  // [0..100]
     bool  m_showShortestHint = true;    // draw outline on shortest-corridor cells
 
+    // Near-optimal alternatives: following one of them closely counts as staying on course
+    NearOptimalRoutes m_routes;
+    NearOptimalRoutes::Options m_routeOptions;
+    float m_routeMatchMin = 0.9f;       // share of cells a player path must have in common with a route
+    int   m_matchedRoute = -1;          // route the scored path followed, -1 if none
+
     int idx(const Node* n) const { return n->row * m_cols + n->col; }
 
-    void computeBfsDistances(Node* src, std::vector<int>& dist);
+    void computeBfsDistances(Node* src, std::vector<int>& dist, const std::vector<char>* mask = nullptr);
+    void computeBfsDistances(const std::vector<Node*>& sources, std::vector<int>& dist, const std::vector<char>* mask = nullptr);
     bool computeShortestCorridor();   // fills m_shortestSteps + m_onShortest
+
+    // Exact BFS distance from every cell to the nearest goal (FlowField::UNREACHABLE
+    // if cut off). Lives in m_flow: built once, repaired locally on wall toggles.
+    const std::vector<int>& distGoal();
     bool computeScore();              // updates m_score + stats, returns true if scored
     void resetScore();                
     void drawShortestHintOverlay() const;
@@ -177,6 +405,7 @@ private:
 
     bool loadLevelFromFile(const std::string& relPath);
     void loadNextLevel(int difficulty);  // easy/medium/hard
+    bool exportWallImpact(const std::string& relPath);   // impact map as text, strongest walls first
     void rebuildGrid(int newRows, int newCols);
 
 	// --- Fonts + Title ---
@@ -186,5 +415,5 @@ private:
 
 	// --- A* speed control ---
     int m_speedIndex = 3; // start in the middle
-    static constexpr float SPEED_LEVELS[7] = { 200, 120, 80, 50, 30, 18, 10 };
+    static constexpr float SPEED_LEVELS[9] = { 200, 120, 80, 50, 30, 18, 10, 2, 0 };
 };
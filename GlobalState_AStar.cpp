@@ -1,4 +1,5 @@
 ﻿#include "GlobalState.h"
+#include <chrono>
 
 void GlobalState::resetSearchVisuals()
 {
@@ -12,7 +13,7 @@ void GlobalState::resetSearchVisuals()
             n->g = 1e9f; n->h = 0.0f; n->f = 1e9f; n->parent = nullptr;
             continue;
         }
-        if (n == m_goal)
+        if (isGoal(n))
         {
             n->walkable = true;
             n->state = NodeVizState::Goal;
@@ -24,38 +25,318 @@ void GlobalState::resetSearchVisuals()
     }
 }
 
+std::string GlobalState::engineName() const
+{
+    switch (m_engine)
+    {
+    case SearchEngine::Rooms: return "Rooms";
+    case SearchEngine::RSR:   return "RSR";
+    case SearchEngine::Fringe: return "Fringe";
+    case SearchEngine::Weighted: return "Weighted A*";
+    case SearchEngine::Anytime: return "ARA*";
+    case SearchEngine::Theta: return "Theta*";
+    default:                  return "A*";
+    }
+}
+
+GlobalState::SearchEngine GlobalState::activeEngine() const
+{
+    // Rooms, RSR, Fringe and Theta* plan towards one goal cell
+    const bool singleGoalOnly = (m_engine == SearchEngine::Rooms || m_engine == SearchEngine::RSR ||
+        m_engine == SearchEngine::Fringe || m_engine == SearchEngine::Theta);
+    if (m_goals.size() > 1 && singleGoalOnly) return SearchEngine::AStar;
+
+    // They also assume plain grid moves and a one-cell agent; A* covers both
+    if (!m_layout.empty() && singleGoalOnly) return SearchEngine::AStar;
+    if (m_agentSize > 1 && singleGoalOnly) return SearchEngine::AStar;
+    return m_engine;
+}
+
+int GlobalState::engineExpanded() const
+{
+    const SearchEngine engine = activeEngine();
+    if (engine == SearchEngine::RSR) return m_rsr.expandedCount();
+    if (engine == SearchEngine::Fringe) return m_fringe.expandedCount();
+    if (engine == SearchEngine::Theta) return m_theta.expandedCount();
+    return m_pf.expandedCount();
+}
+
+std::string GlobalState::searchStats() const
+{
+    const SearchEngine engine = activeEngine();
+    std::string s = "(" + std::to_string(engineExpanded()) + " expanded";
+    const bool emptyBox =
+        (engine == SearchEngine::RSR) ? m_rsr.usedEmptyBox() :
+        (engine == SearchEngine::Fringe) ? m_fringe.usedEmptyBox() :
+        (engine == SearchEngine::Theta) ? m_theta.usedEmptyBox() : m_pf.usedEmptyBox();
+    if (emptyBox)
+        s += ", no walls in the Start/Goal box: no search";
+    if (engine == SearchEngine::Rooms && !m_foundPath.empty() && m_rooms.lowerBound() >= 0)
+    {
+        // Doorways are costed at their middle cell, so the route is only near-optimal
+        const int lb = m_rooms.lowerBound();
+        const int len = m_foundPath.length();
+        if (len <= lb)
+            s += ", optimal";
+        else
+        {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(2) << ", at most " << (float)len / lb << "x optimal";
+            s += oss.str();
+        }
+    }
+    if (m_goals.size() > 1)
+        s += ", nearest of " + std::to_string(m_goals.size()) + " goals" + (engine != m_engine ? " via A*" : "");
+    else if (!m_layout.empty())
+        s += ", level graph" + std::string(engine != m_engine ? " via A*" : "");
+    if (m_agentSize > 1)
+        s += ", " + std::to_string(m_agentSize) + "x" + std::to_string(m_agentSize) + " agent" + (engine != m_engine ? " via A*" : "");
+    const bool usesPf = (engine != SearchEngine::RSR && engine != SearchEngine::Fringe && engine != SearchEngine::Theta);
+    if (m_pruneDeadEnds && usesPf && m_agentSize == 1 && m_pruner.lastWalkable() > 0)
+    {
+        const int pct = (int)std::round(100.0f * m_pruner.lastPruned() / m_pruner.lastWalkable());
+        s += ", " + std::to_string(pct) + "% pruned";
+    }
+
+    auto kb = [](size_t bytes)
+        {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(1) << bytes / 1024.0 << " KB";
+            return oss.str();
+        };
+    if (m_exactHeuristic && usesPf && m_agentSize == 1)
+        s += ", exact h";
+    if (m_engine == SearchEngine::Weighted || m_engine == SearchEngine::Anytime)
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2) << ", eps " << m_pf.epsilon() << ", bound " << m_publishedBound;
+        s += oss.str();
+    }
+
+    if (engine == SearchEngine::Theta && !m_theta.waypoints().empty())
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << ", any-angle length " << m_theta.length()
+            << " in " << m_theta.waypoints().size() - 1 << " segments, " << m_theta.losChecks() << " LoS checks";
+        s += oss.str();
+    }
+
+    const size_t nodes = m_grid.getAllNodes().size();
+    if (usesPf)
+        s += ", mem " + kb(m_pf.peakMemoryBytes(nodes));
+    else if (engine == SearchEngine::Fringe)
+        s += ", mem " + kb(m_fringe.peakMemoryBytes()) + " vs A* >= " + kb(m_pf.peakMemoryBytes(nodes));
+    return s + ")";
+}
+
+void GlobalState::toggleExactHeuristic()
+{
+    m_exactHeuristic = !m_exactHeuristic;
+    m_status = m_exactHeuristic
+        ? "Heuristic: exact goal distance (cached BFS field), A* expands only optimal-path cells. H: Manhattan"
+        : "Heuristic: Manhattan distance. H: exact";
+}
+
+void GlobalState::startEngine()
+{
+    const SearchEngine engine = activeEngine();
+    m_bgSearch.cancel();
+    m_pf.cancel();
+    m_foundPath.clear();
+    m_rsr.cancel();
+    m_fringe.cancel();
+    m_theta.cancel();
+
+    if (engine == SearchEngine::Fringe)
+    {
+        m_fringe.start(m_grid, m_start, m_goal);
+        return;
+    }
+
+    if (engine == SearchEngine::Theta)
+    {
+        if (m_thetaDirty)
+        {
+            m_theta.build(m_grid);
+            m_thetaDirty = false;
+        }
+        m_theta.start(m_grid, m_start, m_goal);
+        return;
+    }
+
+    if (engine == SearchEngine::RSR)
+    {
+        if (m_rsrDirty)
+        {
+            m_rsr.build(m_grid);
+            m_rsrDirty = false;
+        }
+        m_rsr.start(m_start, m_goal);
+        return;
+    }
+
+    m_pf.clearSearchMask();
+    m_pf.clearExactHeuristic();
+    m_pf.clearClearance();
+    m_pf.setGraph(&ensureGraph(), &m_grid.getAllNodes());
+    m_pf.setWallTable((m_layout.empty() && m_agentSize == 1) ? &m_grid : nullptr);
+
+    if (m_agentSize > 1)
+    {
+        // The search moves the agent's top-left cell and stops once the footprint
+        // covers a goal. The goal distance field and the dead-end marks are for a
+        // one-cell agent, so neither is used here.
+        std::vector<Node*> from, to;
+        agentAnchors(m_start, from);
+        for (Node* g : m_goals)
+            agentAnchors(g, to);
+
+        m_pf.setClearance(&m_clearance.values(), m_cols, m_agentSize);
+        m_pf.setMode(m_engine == SearchEngine::Weighted ? Pathfinder::Mode::Weighted : Pathfinder::Mode::Optimal,
+            m_engine == SearchEngine::Weighted ? m_epsilon : 1.0f);
+        m_pf.start(from.empty() ? nullptr : from.front(), to, m_rows, m_cols);
+        return;
+    }
+
+    if (m_exactHeuristic)
+        m_pf.setExactHeuristic(&distGoal(), m_cols, FlowField::UNREACHABLE);
+
+    if (m_engine == SearchEngine::Weighted)
+        m_pf.setMode(Pathfinder::Mode::Weighted, m_epsilon);
+    else if (m_engine == SearchEngine::Anytime)
+        m_pf.setMode(Pathfinder::Mode::Anytime, m_epsilon);
+    else
+        m_pf.setMode(Pathfinder::Mode::Optimal, 1.0f);
+
+    const std::vector<char>* mask = nullptr;
+    if (m_pruneDeadEnds)
+    {
+        buildPruneMask();
+        mask = &m_pruneMask;
+    }
+
+    if (engine == SearchEngine::Rooms)
+    {
+        // Plan on the room graph, then let A* search only the rooms on that route
+        planRoomRoute();
+        if (mask)
+        {
+            for (size_t i = 0; i < m_roomMask.size(); i++)
+                m_roomMask[i] = m_roomMask[i] && (*mask)[i];
+        }
+        mask = &m_roomMask;
+    }
+
+    if (mask)
+        m_pf.setSearchMask(mask, m_cols);
+
+    m_pf.start(m_start, m_goals, m_rows, m_cols);
+}
+
+Pathfinder::Result GlobalState::stepEngine()
+{
+    const SearchEngine engine = activeEngine();
+    if (engine == SearchEngine::RSR) return m_rsr.step();
+    if (engine == SearchEngine::Fringe) return m_fringe.step();
+    if (engine == SearchEngine::Theta) return m_theta.step();
+    return m_pf.step();
+}
+
+Pathfinder::Progress GlobalState::stepEngineFor(int maxExpansions, double maxMicros)
+{
+    const SearchEngine engine = activeEngine();
+    if (engine != SearchEngine::RSR && engine != SearchEngine::Fringe && engine != SearchEngine::Theta)
+        return m_pf.stepFor(maxExpansions, maxMicros);
+
+    // RSR, Fringe and Theta* expand one node per step as well; give them the same contract
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+    auto elapsedUs = [&]() { return std::chrono::duration<double, std::micro>(Clock::now() - t0).count(); };
+
+    Pathfinder::Progress p;
+    while (true)
+    {
+        p.result = stepEngine();
+        if (p.result != Pathfinder::Result::Running) break;
+        p.expansions++;
+        if (maxExpansions > 0 && p.expansions >= maxExpansions) break;
+        if (maxMicros > 0.0 && (p.expansions & 15) == 0 && elapsedUs() >= maxMicros) break;
+    }
+    p.elapsedUs = elapsedUs();
+    return p;
+}
+
+Path GlobalState::enginePath() const
+{
+    const SearchEngine engine = activeEngine();
+    if (engine == SearchEngine::RSR) return m_rsr.path();
+    if (engine == SearchEngine::Fringe) return m_fringe.path();
+    if (engine == SearchEngine::Theta) return m_theta.path();
+    return m_pf.path();
+}
+
+void GlobalState::markEnginePath()
+{
+    // ARA* republishes better paths; demote the previous one first
+    for (Node* n : m_grid.getAllNodes())
+        if (n->state == NodeVizState::Path) n->state = NodeVizState::Closed;
+    m_publishedBound = m_pf.suboptimalityBound();
+
+    m_foundPath = enginePath();
+
+    const std::vector<Node*>& nodes = m_grid.getAllNodes();
+    for (int cell : m_foundPath.cells())
+    {
+        Node* n = nodes[cell];
+        if (n != m_start && !isGoal(n))
+            n->state = NodeVizState::Path;
+    }
+}
+
 bool GlobalState::runAStar()
 {
     if (!m_start || !m_goal) return false;
 
     resetSearchVisuals();
+    startEngine();
 
-    m_pf.cancel();
-    m_pf.start(m_start, m_goal);
+    // ARA* publishes its first path immediately, then tightens epsilon until the deadline
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::microseconds((long long)(m_deadlineMs * 1000.0f));
+    bool found = false;
 
     while (true)
     {
-        auto res = m_pf.step();
+        auto res = stepEngine();
         if (res == Pathfinder::Result::Found)
         {
-            Node* p = m_goal->parent;
-            while (p && p != m_start)
-            {
-                p->state = NodeVizState::Path;
-                p = p->parent;
-            }
-            return true;
+            markEnginePath();
+            found = true;
+
+            if (m_engine != SearchEngine::Anytime || !m_pf.canImprove() || Clock::now() >= deadline)
+                return true;
+            m_pf.improve();
+            continue;
         }
         if (res == Pathfinder::Result::NoPath)
         {
-            return false;
+            return found;
+        }
+        if (found && (m_pf.expandedCount() & 63) == 0 && Clock::now() >= deadline)
+        {
+            return true;   // keep the last published path
         }
     }
 }
 
 void GlobalState::cancelAStar()
 {
+    m_bgSearch.cancel();
     m_pf.cancel();
+    m_foundPath.clear();
+    m_rsr.cancel();
+    m_fringe.cancel();
+    m_theta.cancel();
     m_aState = AStarRunState::Idle;
     m_stepAccumMs = 0.0f;
 
@@ -68,36 +349,37 @@ void GlobalState::startAStar()
     if (!m_start || !m_goal) return;
 
     resetSearchVisuals();
-    m_pf.start(m_start, m_goal);
+    startEngine();
 
     m_stepAccumMs = 0.0f;
     m_aState = AStarRunState::Running;
-    m_status = "A*: running (step-by-step)... SPACE pause/resume | R reset";
+    m_status = engineName() + ": running (step-by-step)... SPACE pause/resume | R reset";
 }
 
-bool GlobalState::stepAStar()
+bool GlobalState::stepAStar(int maxExpansions, double maxMicros)
 {
-    auto res = m_pf.step();
+    auto res = stepEngineFor(maxExpansions, maxMicros).result;
 
     if (res == Pathfinder::Result::Found)
     {
-        // reconstruct path
-        Node* p = m_goal->parent;
-        while (p && p != m_start)
+        markEnginePath();
+
+        if (m_engine == SearchEngine::Anytime && m_pf.improve())
         {
-            p->state = NodeVizState::Path;
-            p = p->parent;
+            // Keep animating the next, tighter ARA* round
+            m_status = engineName() + ": path published, improving... " + searchStats();
+            return false;
         }
 
         m_aState = AStarRunState::Found;
-        m_status = "A*: Path found!";
+        m_status = engineName() + ": Path found! " + searchStats();
         return true;
     }
 
     if (res == Pathfinder::Result::NoPath)
     {
         m_aState = AStarRunState::NoPath;
-        m_status = "A*: No path.";
+        m_status = engineName() + ": No path. " + searchStats();
         return true;
     }
 
@@ -0,0 +1,63 @@
+#include "GlobalState.h"
+#include <chrono>
+
+void GlobalState::runLevelAnalytics()
+{
+    if (!m_start)
+    {
+        m_status = "Level analytics needs a Start.";
+        return;
+    }
+
+    // Every cell reachable from the Start is a BFS source: its eccentricity is
+    // the farthest any other cell of that region is from it
+    std::vector<int> fromStart;
+    computeBfsDistances(m_start, fromStart);
+    std::vector<int> cells;
+    for (int i = 0; i < (int)fromStart.size(); i++)
+        if (fromStart[i] < FlowField::UNREACHABLE) cells.push_back(i);
+
+    // All-cells eccentricity is quadratic; on big grids the cells of every k-th
+    // 8x8 tile stand in (the radius becomes an estimate). Whole tiles keep each
+    // 64-source pass in step, see BitParallelBfs.
+    const size_t maxSources = 1024;
+    const bool sampled = cells.size() > maxSources;
+    if (sampled)
+    {
+        const int tilesPerRow = (m_cols + 7) / 8;
+        const int stride = (int)((cells.size() + maxSources - 1) / maxSources);
+        std::vector<int> kept;
+        for (int cell : cells)
+        {
+            const int tile = (cell / m_cols / 8) * tilesPerRow + (cell % m_cols) / 8;
+            if (tile % stride == 0 || cell == idx(m_start)) kept.push_back(cell);
+        }
+        cells.swap(kept);
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::vector<int> ecc = m_multiBfs.eccentricities(ensureGraph(), cells);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    int diameter = 0;
+    int radius = FlowField::UNREACHABLE;
+    int center = idx(m_start);
+    int startEcc = 0;
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        diameter = std::max(diameter, ecc[i]);
+        if (ecc[i] < radius) { radius = ecc[i]; center = cells[i]; }
+        if (cells[i] == idx(m_start)) startEcc = ecc[i];
+    }
+
+    // The bit-parallel BFS counts moves: on a weighted layout the figures are hop
+    // counts, not the arc costs the searches and scoring use
+    const char* unit = ensureGraph().weighted() ? " hops (arc weights ignored)" : "";
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "Level analytics: " << cells.size() << (sampled ? " sampled" : "") << " cells, diameter " << diameter << ", radius " << radius << unit
+        << " (center " << center / m_cols << "," << center % m_cols << "), Start eccentricity " << startEcc
+        << " | " << m_multiBfs.lastPasses() << " passes of 64 sources, " << ms << " ms";
+    m_status = oss.str();
+}
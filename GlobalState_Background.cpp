@@ -0,0 +1,82 @@
+#include "GlobalState.h"
+#include <chrono>
+
+bool GlobalState::startBackgroundAStar()
+{
+    // Only plain and weighted A* have a worker version; the other engines are
+    // bounded (ARA* deadline) or cheap enough to stay on the render thread
+    const SearchEngine engine = activeEngine();
+    if (engine != SearchEngine::AStar && engine != SearchEngine::Weighted) return false;
+    if (!m_layout.empty()) return false;   // the worker walks grid moves; imported arcs need the graph search
+    if (m_agentSize > 1) return false;      // nor does it know the clearance map
+    if (!m_start || !m_goal) return true;
+
+    m_aState = AStarRunState::Idle;
+    resetSearchVisuals();
+    m_pf.cancel();
+    m_foundPath.clear();   // the overlays must not draw the previous search's path
+
+    std::vector<int> goals;
+    for (const Node* g : m_goals)
+        goals.push_back(idx(g));
+
+    const float weight = (engine == SearchEngine::Weighted) ? m_epsilon : 1.0f;
+    m_bgSearch.start(gridSnapshot(), idx(m_start), goals, weight,
+        m_exactHeuristic ? &distGoal() : nullptr);
+    m_bgUiMs = 0.0f;
+    m_bgFrames = 0;
+
+    m_status = "Instant " + engineName() + ": searching on a worker thread... R: cancel";
+    return true;
+}
+
+void GlobalState::drainBackgroundAStar(float dtMs)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    m_bgUiMs += dtMs;
+    m_bgFrames++;
+
+    const std::vector<Node*>& nodes = m_grid.getAllNodes();
+    BackgroundSearch::Event e;
+    for (int i = 0; i < m_bgDrainPerFrame && m_bgSearch.poll(e); i++)
+    {
+        if (e.kind == BackgroundSearch::Event::Open)
+        {
+            nodes[e.cell]->state = NodeVizState::Open;
+        }
+        else if (e.kind == BackgroundSearch::Event::Closed)
+        {
+            nodes[e.cell]->state = NodeVizState::Closed;
+        }
+        else if (e.kind == BackgroundSearch::Event::Path)
+        {
+            nodes[e.cell]->state = NodeVizState::Path;
+        }
+        else
+        {
+            const bool found = (e.kind == BackgroundSearch::Event::Found);
+            m_aState = found ? AStarRunState::Found : AStarRunState::NoPath;
+            if (found) m_foundPath = m_bgSearch.path();
+
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(1)
+                << "Instant " << engineName() << (found ? ": Path found! " : ": No path. ")
+                << "(" << m_bgSearch.expandedCount() << " expanded";
+            if (found) oss << ", length " << e.value;
+            oss << ", worker " << m_bgSearch.workerMs() << " ms, shown over " << m_bgFrames << " frames)";
+            m_status = oss.str();
+
+            // The worker has returned after its last event; join it
+            m_bgSearch.cancel();
+            return;
+        }
+    }
+
+    const double drainUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(0)
+        << "Instant " << engineName() << " on worker: " << m_bgSearch.expandedCount() << " expanded, "
+        << m_bgUiMs << " ms | " << m_bgSearch.backlog() << " events queued | paint " << drainUs << " us/frame | R: cancel";
+    m_status = oss.str();
+}
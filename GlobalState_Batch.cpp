@@ -0,0 +1,92 @@
+#include "GlobalState.h"
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+void GlobalState::runBatchBenchmark(int queryCount)
+{
+    // Work on a snapshot: the live grid and its Nodes are not touched
+    const GridSnapshot snap = gridSnapshot();
+
+    std::vector<int> free;
+    for (int i = 0; i < snap.cellCount(); i++)
+        if (snap.walkableAt(i)) free.push_back(i);
+
+    if (free.size() < 2)
+    {
+        m_status = "Batch: not enough free cells.";
+        return;
+    }
+
+    std::vector<BatchPathfinder::Query> queries(queryCount);
+    for (BatchPathfinder::Query& q : queries)
+    {
+        q.start = free[rand() % free.size()];
+        q.goal = free[rand() % free.size()];
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto timeRun = [&](int threads, std::vector<BatchPathfinder::Result>& out)
+        {
+            const auto t0 = Clock::now();
+            out = m_batch.run(snap, queries, threads, false);
+            return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        };
+
+    std::vector<BatchPathfinder::Result> serial, parallel;
+    const double ms1 = timeRun(1, serial);
+    const double msN = timeRun(0, parallel);
+    const int threads = m_batch.lastThreadCount();
+
+    int solved = 0;
+    for (const BatchPathfinder::Result& r : parallel)
+        if (r.found) solved++;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "Batch: " << queryCount << " queries (" << solved << " solvable), "
+        << ms1 << " ms on 1 thread, " << msN << " ms on " << threads << " threads ("
+        << (msN > 0.0 ? ms1 / msN : 0.0) << "x)";
+    m_status = oss.str();
+}
+
+void GlobalState::runParallelAStarBenchmark()
+{
+    if (!m_start || !m_goal)
+    {
+        m_status = "HDA*: needs a Start and a Goal.";
+        return;
+    }
+
+    const GridSnapshot snap = gridSnapshot();
+    const int startCell = idx(m_start);
+    const int goalCell = idx(m_goal);   // the first goal on multi-goal levels
+
+    using Clock = std::chrono::steady_clock;
+    auto t0 = Clock::now();
+    const std::vector<BatchPathfinder::Result> serial = m_batch.run(snap, { { startCell, goalCell } }, 1, false);
+    const double msSerial = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    const BatchPathfinder::Result& ref = serial[0];
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "HDA*: serial A* " << msSerial << " ms, " << ref.expanded << " exp";
+
+    // 1, 2, 4... up to every hardware thread
+    const int maxThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    for (int threads = 1; ; threads = std::min(threads * 2, maxThreads))
+    {
+        t0 = Clock::now();
+        const ParallelAStar::Result r = m_hda.run(snap, startCell, goalCell, threads);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        oss << " | " << threads << "t: " << ms << " ms (" << (ms > 0.0 ? msSerial / ms : 0.0) << "x), "
+            << (ref.expanded > 0 ? 100.0 * (r.expanded - ref.expanded) / ref.expanded : 0.0) << "% more exp, "
+            << r.messages << " msgs";
+        if (r.length != ref.length) oss << ", LENGTH " << r.length << " vs " << ref.length;
+
+        if (threads == maxThreads) break;
+    }
+    if (!ref.found) oss << " | no path";
+    m_status = oss.str();
+}
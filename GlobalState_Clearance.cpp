@@ -0,0 +1,60 @@
+#include "GlobalState.h"
+#include "graphics.h"
+
+void GlobalState::agentAnchors(const Node* cell, std::vector<Node*>& out) const
+{
+    // Every top-left corner of a k x k footprint that covers the cell and fits, the cell itself first
+    if (!cell || m_clearance.empty()) return;
+    for (int dr = 0; dr < m_agentSize; dr++)
+    {
+        for (int dc = 0; dc < m_agentSize; dc++)
+        {
+            Node* a = nodeAt(cell->row - dr, cell->col - dc);
+            if (!a || !m_clearance.fits(idx(a), m_agentSize)) continue;
+            if (std::find(out.begin(), out.end(), a) == out.end()) out.push_back(a);
+        }
+    }
+}
+
+void GlobalState::cycleAgentSize()
+{
+    cancelAStar();
+    resetScore();
+
+    m_agentSize = m_agentSize % 3 + 1;
+    const std::string k = std::to_string(m_agentSize);
+    m_status = (m_agentSize == 1)
+        ? std::string("Agent size 1x1.")
+        : "Agent size " + k + "x" + k + ": A* enters a cell only if its clearance is >= " + k +
+          " (the agent's top-left corner); the route is done once the agent covers a goal.";
+}
+
+void GlobalState::drawAgentFootprint() const
+{
+    if (m_agentSize <= 1 || m_foundPath.empty()) return;
+
+    graphics::Brush br;
+    br.outline_opacity = 0.0f;
+    br.fill_opacity = 0.12f;
+    br.fill_color[0] = 0.2f; br.fill_color[1] = 0.6f; br.fill_color[2] = 1.0f;
+
+    // The swept area: one translucent k x k square per anchor along the route
+    const float side = m_agentSize * m_cell;
+    for (int cell : m_foundPath.cells())
+    {
+        const float x = m_originX + (cell % m_cols) * m_cell + side * 0.5f;
+        const float y = m_originY + (cell / m_cols) * m_cell + side * 0.5f;
+        graphics::drawRect(x, y, side, side, br);
+    }
+
+    br.fill_opacity = 0.0f;
+    br.outline_opacity = 0.9f;
+    br.outline_width = 2.0f;
+    br.outline_color[0] = 0.2f; br.outline_color[1] = 0.6f; br.outline_color[2] = 1.0f;
+    for (int cell : { m_foundPath.front(), m_foundPath.back() })
+    {
+        const float x = m_originX + (cell % m_cols) * m_cell + side * 0.5f;
+        const float y = m_originY + (cell / m_cols) * m_cell + side * 0.5f;
+        graphics::drawRect(x, y, side - 2.0f, side - 2.0f, br);
+    }
+}
@@ -0,0 +1,142 @@
+#include "GlobalState.h"
+#include "graphics.h"
+#include <cstdlib>
+
+void GlobalState::ensureFlowField()
+{
+    if (!m_flowDirty && !m_flow.empty() && m_flow.sameGoals(m_goals)) return;
+
+    // One goal-rooted (multi-source) BFS serves every agent. Agents walk grid
+    // moves only, so imported arcs of a level graph are left out of the field.
+    std::vector<int> dist;
+    if (m_layout.empty())
+    {
+        computeBfsDistances(m_goals, dist);
+    }
+    else
+    {
+        std::vector<int> goals;
+        for (const Node* g : m_goals)
+            goals.push_back(idx(g));
+        CsrGraph::fromGrid(m_grid).distances(goals, dist, FlowField::UNREACHABLE);
+    }
+    m_flow.build(m_grid, m_goals, dist);
+    m_flowDirty = false;
+}
+
+void GlobalState::spawnAgent(CrowdAgent& a, const std::vector<int>& freeCells)
+{
+    a.cell = freeCells.empty() ? -1 : freeCells[rand() % freeCells.size()];
+    a.next = -1;
+    a.t = 0.0f;
+}
+
+void GlobalState::toggleCrowd(int agentCount)
+{
+    m_crowdOn = !m_crowdOn;
+    m_agents.clear();
+    m_crowdArrivals = 0;
+
+    if (!m_crowdOn)
+    {
+        m_status = "Crowd: off.";
+        return;
+    }
+
+    ensureFlowField();
+
+    std::vector<int> freeCells;
+    for (Node* n : m_grid.getAllNodes())
+        if (n->walkable && !isGoal(n)) freeCells.push_back(idx(n));
+
+    m_agents.resize(agentCount);
+    for (CrowdAgent& a : m_agents)
+        spawnAgent(a, freeCells);
+
+    m_status = "Crowd: " + std::to_string(agentCount) + " agents following the flow field (F: off).";
+}
+
+void GlobalState::updateCrowd(float dtMs)
+{
+    ensureFlowField();
+
+    std::vector<int> freeCells;   // only filled if someone has to respawn
+    auto respawn = [&](CrowdAgent& a)
+        {
+            if (freeCells.empty())
+            {
+                for (Node* n : m_grid.getAllNodes())
+                    if (n->walkable && !isGoal(n)) freeCells.push_back(idx(n));
+            }
+            spawnAgent(a, freeCells);
+        };
+
+    const float step = m_agentSpeed * dtMs / 1000.0f;
+    const std::vector<Node*>& nodes = m_grid.getAllNodes();
+
+    for (CrowdAgent& a : m_agents)
+    {
+        if (a.cell < 0) continue;
+
+        // Grid was resized, or a wall dropped on the agent: put it somewhere else
+        if (a.cell >= (int)nodes.size() || a.next >= (int)nodes.size())
+        {
+            respawn(a);
+            continue;
+        }
+        if (!nodes[a.cell]->walkable || (a.next >= 0 && !nodes[a.next]->walkable))
+        {
+            respawn(a);
+            continue;
+        }
+
+        if (a.next < 0)
+            a.next = m_flow.next(a.cell);
+        if (a.next < 0)
+        {
+            if (m_flow.distance(a.cell) == 0)
+            {
+                m_crowdArrivals++;
+                respawn(a);
+            }
+            continue;   // cut off from every goal: wait for a wall to open
+        }
+
+        a.t += step;
+        while (a.t >= 1.0f && a.next >= 0)
+        {
+            a.t -= 1.0f;
+            a.cell = a.next;
+            a.next = m_flow.next(a.cell);
+        }
+        if (a.next < 0) a.t = 0.0f;
+    }
+}
+
+void GlobalState::drawCrowd() const
+{
+    if (!m_crowdOn) return;
+
+    graphics::Brush br;
+    br.fill_opacity = 0.9f;
+    br.outline_opacity = 0.0f;
+    br.fill_color[0] = 0.95f;
+    br.fill_color[1] = 0.35f;
+    br.fill_color[2] = 0.75f;
+
+    const float radius = m_cell * 0.22f;
+    for (const CrowdAgent& a : m_agents)
+    {
+        if (a.cell < 0) continue;
+
+        float r = (float)(a.cell / m_cols);
+        float c = (float)(a.cell % m_cols);
+        if (a.next >= 0)
+        {
+            r += (a.next / m_cols - r) * a.t;
+            c += (a.next % m_cols - c) * a.t;
+        }
+
+        graphics::drawDisk(m_originX + (c + 0.5f) * m_cell, m_originY + (r + 0.5f) * m_cell, radius, br);
+    }
+}
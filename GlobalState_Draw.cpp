@@ -59,7 +59,16 @@ void GlobalState::draw() const
     for (const VisualAsset* a : m_drawables)
         a->draw();
 
+    drawGraphLayout();
     drawShortestHintOverlay();
+    drawWallImpactOverlay();
+    drawRoomOverlay();
+    drawAnyAnglePath();
+    drawAgentFootprint();
+    drawCrowd();
+    drawMapf();
+    drawPatrols();
+    drawPathRequests();
 
     // Draw UI elements ONLY if help is NOT showing
     if (!m_showHelp)
@@ -87,6 +96,8 @@ void GlobalState::draw() const
             " | eff " + std::to_string((int)std::round(m_efficiency * 100.0f)) + "%" +
             " | shortest " + std::to_string(m_shortestSteps) +
             " | yours " + std::to_string(m_playerSteps);
+    if (m_matchedRoute > 0)
+        stats += " | route " + std::to_string(m_matchedRoute + 1) + "/" + std::to_string(m_routes.routes().size());
     std::string line = (m_score > 0) ? stats : m_status;
     graphics::drawText(350.0f, 50.0f, 23.0f, line, t);
 
@@ -215,6 +226,9 @@ void GlobalState::draw() const
         drawBold(labelX, y, 16.0f, "D", txt);
         graphics::drawText(descX, y, 16.0f, "Toggle Draw Mode.", dimTxt); y += 28.0f;
 
+        drawBold(labelX, y, 16.0f, "Ctrl+Z / Ctrl+Y", txt);
+        graphics::drawText(descX, y, 16.0f, "Undo / redo wall and START/GOAL edits.", dimTxt); y += 22.0f;
+
         drawBold(labelX, y, 16.0f, "I", txt);
         graphics::drawText(descX, y, 16.0f, "Instant A* search solution.", dimTxt); y += 28.0f;
     }
@@ -245,3 +259,33 @@ void GlobalState::drawShortestHintOverlay() const
         graphics::drawRect(cx, cy, m_cell - 6.0f, m_cell - 6.0f, br);
     };
 }
+
+void GlobalState::drawAnyAnglePath() const
+{
+    if (activeEngine() != SearchEngine::Theta) return;
+    const std::vector<int>& pts = m_theta.waypoints();
+    if (pts.size() < 2) return;
+
+    graphics::Brush line;
+    line.outline_opacity = 0.95f;
+    line.outline_width = 3.0f;
+    line.outline_color[0] = 1.0f; line.outline_color[1] = 0.85f; line.outline_color[2] = 0.2f;
+
+    graphics::Brush dot;
+    dot.outline_opacity = 0.0f;
+    dot.fill_opacity = 0.95f;
+    dot.fill_color[0] = 1.0f; dot.fill_color[1] = 0.85f; dot.fill_color[2] = 0.2f;
+
+    // Straight segments between turning points; the painted cells underneath are the same route on the grid
+    for (size_t i = 0; i < pts.size(); i++)
+    {
+        const float x = m_originX + (pts[i] % m_cols) * m_cell + m_cell * 0.5f;
+        const float y = m_originY + (pts[i] / m_cols) * m_cell + m_cell * 0.5f;
+        graphics::drawRect(x, y, m_cell * 0.2f, m_cell * 0.2f, dot);
+        if (i == 0) continue;
+
+        const float px = m_originX + (pts[i - 1] % m_cols) * m_cell + m_cell * 0.5f;
+        const float py = m_originY + (pts[i - 1] / m_cols) * m_cell + m_cell * 0.5f;
+        graphics::drawLine(px, py, x, y, line);
+    }
+}
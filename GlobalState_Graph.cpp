@@ -0,0 +1,78 @@
+#include "GlobalState.h"
+#include "graphics.h"
+#include <fstream>
+
+const CsrGraph& GlobalState::ensureGraph()
+{
+    if (!m_graphDirty && m_graph.nodeCount() == m_rows * m_cols) return m_graph;
+
+    m_graph = m_layout.empty() ? CsrGraph::fromGrid(m_grid) : CsrGraph::fromLayout(m_grid, m_layout);
+    m_graphReverse = m_graph.symmetric() ? CsrGraph() : m_graph.reversed();
+    m_graphDirty = false;
+    m_layoutGoalDirty = true;
+    return m_graph;
+}
+
+bool GlobalState::loadGraphLayout(const std::string& levelPath)
+{
+    m_layout = CsrGraph::Layout();
+    m_graphDirty = true;
+    m_layoutGoalDirty = true;
+
+    const size_t dot = levelPath.rfind(".txt");
+    const std::string path = (dot == std::string::npos ? levelPath : levelPath.substr(0, dot)) + ".graph.txt";
+    if (!std::ifstream(path).is_open()) return true;   // no graph file: plain grid moves
+
+    std::string error;
+    if (!CsrGraph::loadLayout(path, m_rows, m_cols, m_layout, error))
+    {
+        m_layout = CsrGraph::Layout();
+        m_status = "Bad graph file: " + error;
+        return false;
+    }
+    return true;
+}
+
+void GlobalState::computeGoalDistances(std::vector<int>& dist)
+{
+    const CsrGraph& g = ensureGraph();
+
+    std::vector<int> goals;
+    for (const Node* n : m_goals)
+        if (n) goals.push_back(idx(n));
+
+    // Distance *to* a goal follows arcs backwards; on a symmetric graph that is the same graph
+    const CsrGraph& toGoal = g.symmetric() ? g : m_graphReverse;
+    toGoal.distances(goals, dist, FlowField::UNREACHABLE);
+}
+
+void GlobalState::drawGraphLayout() const
+{
+    if (m_layout.arcs.empty()) return;
+
+    graphics::Brush line;
+    line.outline_opacity = 0.8f;
+    line.outline_width = 2.0f;
+    line.outline_color[0] = 0.3f; line.outline_color[1] = 0.85f; line.outline_color[2] = 1.0f;
+
+    graphics::Brush head;
+    head.outline_opacity = 0.0f;
+    head.fill_opacity = 0.9f;
+    head.fill_color[0] = 0.3f; head.fill_color[1] = 0.85f; head.fill_color[2] = 1.0f;
+
+    auto center = [&](int cell, float& x, float& y)
+        {
+            x = m_originX + (cell % m_cols) * m_cell + m_cell * 0.5f;
+            y = m_originY + (cell / m_cols) * m_cell + m_cell * 0.5f;
+        };
+
+    // Imported arcs only; the plain grid moves need no drawing. The square marks the arc's target end.
+    for (const CsrGraph::Arc& a : m_layout.arcs)
+    {
+        float x1, y1, x2, y2;
+        center(a.from, x1, y1);
+        center(a.to, x2, y2);
+        graphics::drawLine(x1, y1, x2, y2, line);
+        graphics::drawRect(x1 + (x2 - x1) * 0.8f, y1 + (y2 - y1) * 0.8f, m_cell * 0.25f, m_cell * 0.25f, head);
+    }
+}
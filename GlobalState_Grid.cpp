@@ -1,4 +1,5 @@
 #include "GlobalState.h"
+#include <algorithm>
 
 Node* GlobalState::nodeAt(int r, int c) const
 {
@@ -10,6 +11,25 @@ Node* GlobalState::nodeFromMouse(float mx, float my) const
     return m_grid.getNodeFromPoint(mx, my);
 }
 
+bool GlobalState::isGoal(const Node* n) const
+{
+    return n && std::find(m_goals.begin(), m_goals.end(), n) != m_goals.end();
+}
+
+void GlobalState::setSingleGoal(Node* n)
+{
+    for (Node* g : m_goals)
+        if (g && g != n && g->state == NodeVizState::Goal) g->state = NodeVizState::Empty;
+
+    m_goal = n;
+    m_goals.clear();
+    if (n)
+    {
+        m_goals.push_back(n);
+        n->state = NodeVizState::Goal;
+    }
+}
+
 void GlobalState::buildGridGraph()
 {
     // Create nodes + neighbors in Grid
@@ -21,12 +41,111 @@ void GlobalState::buildGridGraph()
 
     for (Node* n : m_grid.getAllNodes())
         m_drawables.push_back(n);
+
+    m_journal.clear();   // cell indices of the old grid mean nothing now
+    onWallsChanged();
+}
+
+GridSnapshot GlobalState::gridSnapshot()
+{
+    // Walls are kept in step by onWallsChanged; Start/Goal moves are picked up here
+    std::vector<int> goals;
+    for (const Node* g : m_goals)
+        goals.push_back(idx(g));
+    m_gridStore.setMarkers(m_start ? idx(m_start) : -1, goals);
+    return m_gridStore.snapshot();
+}
+
+void GlobalState::onWallsChanged(Node* changed)
+{
+    // The grid's wall table first: the caches below may query it
+    if (changed)
+        m_grid.onWallToggled(changed->row, changed->col);
+    else
+        m_grid.rebuildWallTable();
+
+    // Snapshot planes: one cell written (its chunk copied if a snapshot shares it), or a chunk-by-chunk compare
+    if (changed)
+        m_gridStore.setWalkable(idx(changed), changed->walkable);
+    else
+        m_gridStore.syncFrom(m_grid);
+
+    // Room decomposition is rebuilt lazily on the next room-graph search
+    m_roomsDirty = true;
+    m_impactDirty = true;
+
+    // A plain grid graph has its five affected cells rewritten in place; imported layouts are rebuilt
+    if (changed && !m_graphDirty && m_graph.onWallToggled(m_grid, changed->row, changed->col))
+        m_layoutGoalDirty = true;
+    else
+        m_graphDirty = true;
+
+    // Dead-end marks are repaired around a single edit while pruning is on; otherwise
+    // (after bulk edits, or an edit inside a block spanning much of the map) they are
+    // rebuilt on the next pruned search
+    if (changed && !m_prunerDirty && m_pruneDeadEnds)
+    {
+        if (!m_pruner.update(m_grid, changed->row, changed->col))
+            m_prunerDirty = true;
+    }
+    else
+        m_prunerDirty = true;
+
+    // RSR rectangles are rebuilt locally around a single toggled cell
+    if (changed && !m_rsrDirty)
+        m_rsr.onWallToggled(changed->row, changed->col);
+    else
+        m_rsrDirty = true;
+
+    // Clearance only changes above and left of a toggled cell; bulk edits (level loads) rebuild it in one pass
+    if (changed && !m_clearance.empty())
+        m_clearance.onWallToggled(m_grid, changed->row, changed->col);
+    else
+        m_clearance.build(m_grid);
+
+    // Theta*'s wall bitboards flip one bit per toggled cell
+    if (changed && !m_thetaDirty)
+        m_theta.onWallToggled(changed->row, changed->col, !changed->walkable);
+    else
+        m_thetaDirty = true;
+
+    // Patrol runner repairs its route around a single edit; bulk edits end the mode
+    if (m_patrolOn)
+    {
+        if (changed) m_patrol.onWallToggled(idx(changed));
+        else { m_patrolOn = false; m_patrol.clear(); }
+    }
+
+    // Queued path requests restart; after a bulk edit the Node pointers may be gone
+    if (m_pathsOn)
+    {
+        if (changed) { m_paths.onWallsChanged(); m_pathsStale = true; }
+        else { m_pathsOn = false; m_paths.clear(); m_pathRequests.clear(); m_pathMain = -1; }
+    }
+
+    // A worker search runs on a snapshot that no longer matches the walls
+    if (m_bgSearch.active())
+    {
+        m_bgSearch.cancel();
+        m_status = "Instant A*: stopped, the walls changed.";
+    }
+
+    // Multi-agent routes are replanned on the next frame
+    m_mapfDirty = true;
+
+    // The crowd's flow field is repaired around a single toggled cell
+    if (changed && !m_flowDirty)
+        m_flow.onWallToggled(changed->row, changed->col);
+    else
+        m_flowDirty = true;
 }
 
 void GlobalState::clearWallsAndPathKeepEndpoints()
 {
+    std::vector<int> flipped;   // for undo: the walls that go
     for (Node* n : m_grid.getAllNodes())
     {
+        if (!n->walkable) flipped.push_back(idx(n));
         n->walkable = true;
         n->state = NodeVizState::Empty;
         n->parent = nullptr;
@@ -34,7 +153,10 @@ void GlobalState::clearWallsAndPathKeepEndpoints()
     }
 
     if (m_start) m_start->state = NodeVizState::Start;
-    if (m_goal)  m_goal->state = NodeVizState::Goal;
+    for (Node* g : m_goals) g->state = NodeVizState::Goal;
+
+    onWallsChanged();
+    m_journal.record(flipped, nullptr, nullptr, "Clear Walls");
 }
 
 void GlobalState::rebuildGrid(int newRows, int newCols)
@@ -49,12 +171,14 @@ void GlobalState::rebuildGrid(int newRows, int newCols)
 
     m_rows = newRows;
     m_cols = newCols;
+    m_layout = CsrGraph::Layout();   // imported arcs belong to the old grid
 
     setupLayout();
     buildGridGraph();
 
     m_start = nodeAt(m_rows / 2, 2);
     m_goal = nodeAt(m_rows / 2, m_cols - 3);
+    m_goals.assign(1, m_goal);   // old nodes are gone, nothing to repaint
 
     if (m_start) m_start->state = NodeVizState::Start;
     if (m_goal)  m_goal->state = NodeVizState::Goal;
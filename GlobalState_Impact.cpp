@@ -0,0 +1,152 @@
+#include "GlobalState.h"
+#include <chrono>
+#include <fstream>
+
+bool GlobalState::computeWallImpact()
+{
+    if (!m_start || m_goals.empty()) return false;
+    if (!m_impactDirty && m_impactStart == idx(m_start) && m_impactGoals == m_goals) return true;
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // Start distances over every walkable cell: a removed wall can open up a
+    // pruned dead end, so the masked m_distStart of the corridor is not enough
+    std::vector<int> dStart;
+    computeBfsDistances(m_start, dStart);
+    const std::vector<int>& dGoal = distGoal();
+    const int shortest = dGoal[idx(m_start)];
+
+    // Removing wall w allows a -> w -> b for any walkable neighbours a and b, so
+    // the best route through it is min(dStart[a]) + 2 + min(dGoal[b]). Taking
+    // a == b never beats the current route, so the two minima are independent.
+    m_wallImpact.assign(m_rows * m_cols, 0);
+    m_impactMax = 0;
+    m_impactWalls = 0;
+    for (Node* w : m_grid.getAllNodes())
+    {
+        if (!w || w->walkable) continue;
+
+        int minS = FlowField::UNREACHABLE;
+        int minG = FlowField::UNREACHABLE;
+        for (Node* nb : w->neighbors)
+        {
+            if (!nb || !nb->walkable) continue;
+            minS = std::min(minS, dStart[idx(nb)]);
+            minG = std::min(minG, dGoal[idx(nb)]);
+        }
+        if (minS >= FlowField::UNREACHABLE || minG >= FlowField::UNREACHABLE) continue;
+
+        const int via = minS + 2 + minG;
+        int saved = 0;
+        if (shortest >= FlowField::UNREACHABLE) saved = IMPACT_CONNECTS;
+        else if (via < shortest) saved = shortest - via;
+        if (saved == 0) continue;
+
+        m_wallImpact[idx(w)] = saved;
+        m_impactWalls++;
+        if (saved != IMPACT_CONNECTS) m_impactMax = std::max(m_impactMax, saved);
+    }
+
+    m_impactStart = idx(m_start);
+    m_impactGoals = m_goals;
+    m_impactDirty = false;
+    m_impactMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    return true;
+}
+
+void GlobalState::toggleWallImpact()
+{
+    m_impactOn = !m_impactOn;
+    if (!m_impactOn)
+    {
+        m_status = "Wall impact overlay off.";
+        return;
+    }
+
+    if (!computeWallImpact())
+    {
+        m_impactOn = false;
+        m_status = "Wall impact needs a Start and a Goal.";
+        return;
+    }
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(0) << "Wall impact: " << m_impactWalls << " walls would shorten the route";
+    if (m_impactMax > 0) oss << " (best saves " << m_impactMax << " steps)";
+    oss << ", " << m_impactMicros << " us | Shift+W: export";
+    m_status = oss.str();
+}
+
+void GlobalState::drawWallImpactOverlay() const
+{
+    if (!m_impactOn || m_wallImpact.empty()) return;
+
+    graphics::Brush br;
+    br.outline_opacity = 0.0f;
+
+    graphics::Brush txt;
+    txt.fill_color[0] = 1.0f; txt.fill_color[1] = 1.0f; txt.fill_color[2] = 1.0f;
+
+    for (Node* n : m_grid.getAllNodes())
+    {
+        if (!n || n->walkable) continue;
+        const int saved = m_wallImpact[idx(n)];
+        if (saved == 0) continue;
+
+        // Yellow for small savings, red for the biggest; magenta reconnects Start and Goal
+        if (saved == IMPACT_CONNECTS)
+        {
+            br.fill_color[0] = 0.95f; br.fill_color[1] = 0.2f; br.fill_color[2] = 0.9f;
+            br.fill_opacity = 0.85f;
+        }
+        else
+        {
+            const float t = (m_impactMax > 0) ? (float)saved / (float)m_impactMax : 1.0f;
+            br.fill_color[0] = 1.0f; br.fill_color[1] = 0.9f * (1.0f - t) + 0.15f; br.fill_color[2] = 0.1f;
+            br.fill_opacity = 0.35f + 0.5f * t;
+        }
+
+        const float cx = m_originX + n->col * m_cell + m_cell * 0.5f;
+        const float cy = m_originY + n->row * m_cell + m_cell * 0.5f;
+        graphics::drawRect(cx, cy, m_cell - 4.0f, m_cell - 4.0f, br);
+
+        if (saved != IMPACT_CONNECTS && m_cell >= 20.0f)
+            graphics::drawText(cx - m_cell * 0.3f, cy + m_cell * 0.2f, m_cell * 0.5f, std::to_string(saved), txt);
+    }
+}
+
+bool GlobalState::exportWallImpact(const std::string& relPath)
+{
+    if (!computeWallImpact())
+    {
+        m_status = "Wall impact needs a Start and a Goal.";
+        return false;
+    }
+
+    std::ofstream f(relPath);
+    if (!f)
+    {
+        m_status = "Cannot write " + relPath;
+        return false;
+    }
+
+    std::vector<int> walls;
+    for (int i = 0; i < (int)m_wallImpact.size(); i++)
+        if (m_wallImpact[i] != 0) walls.push_back(i);
+    std::stable_sort(walls.begin(), walls.end(),
+        [&](int a, int b) { return m_wallImpact[a] > m_wallImpact[b]; });
+
+    const int shortest = distGoal()[idx(m_start)];
+    f << "# Wall-removal impact" << (m_currentLevelPath.empty() ? "" : " for " + m_currentLevelPath) << "\n";
+    f << "# rows cols shortest (-1: Start and Goal are cut off)\n";
+    f << m_rows << " " << m_cols << " " << (shortest >= FlowField::UNREACHABLE ? -1 : shortest) << "\n";
+    f << "# row col saved (-1: removing the wall reconnects Start and Goal)\n";
+    for (int cell : walls)
+    {
+        const int saved = m_wallImpact[cell];
+        f << cell / m_cols << " " << cell % m_cols << " " << (saved == IMPACT_CONNECTS ? -1 : saved) << "\n";
+    }
+
+    m_status = "Exported " + std::to_string(walls.size()) + " impactful walls to " + relPath;
+    return true;
+}
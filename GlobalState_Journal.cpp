@@ -0,0 +1,78 @@
+#include "GlobalState.h"
+
+EditJournal::Markers GlobalState::currentMarkers() const
+{
+    EditJournal::Markers m;
+    m.start = m_start ? idx(m_start) : -1;
+    for (const Node* g : m_goals)
+        m.goals.push_back(idx(g));
+    return m;
+}
+
+void GlobalState::setMarkers(const EditJournal::Markers& m)
+{
+    if (m_start && m_start->state == NodeVizState::Start) m_start->state = NodeVizState::Empty;
+    for (Node* g : m_goals)
+        if (g && g->state == NodeVizState::Goal) g->state = NodeVizState::Empty;
+
+    const std::vector<Node*>& nodes = m_grid.getAllNodes();
+    const int n = (int)nodes.size();
+    m_start = (m.start >= 0 && m.start < n) ? nodes[m.start] : nullptr;
+    m_goals.clear();
+    for (int g : m.goals)
+        if (g >= 0 && g < n) m_goals.push_back(nodes[g]);
+    m_goal = m_goals.empty() ? nullptr : m_goals.front();
+
+    if (m_start) m_start->state = NodeVizState::Start;
+    for (Node* g : m_goals) g->state = NodeVizState::Goal;
+}
+
+void GlobalState::applyJournalStep(const EditJournal::Step& step, bool undo)
+{
+    // Same as editing by hand: a running search (visual or on the worker) stops, a marker move drops the drawn path
+    if (searchInProgress())
+    {
+        cancelAStar();
+        resetAttemptTimer();
+        resetScore();
+    }
+    if (step.hasMarkers) clearPlayerPath();
+
+    // A few cells go through the per-cell repairs; beyond that one bulk refresh is cheaper
+    const int perCellLimit = 32;
+    const bool perCell = (int)step.flipped.size() <= perCellLimit;
+
+    const std::vector<Node*>& nodes = m_grid.getAllNodes();
+    for (int cell : step.flipped)
+    {
+        Node* n = nodes[cell];
+        n->walkable = !n->walkable;
+        n->state = n->walkable ? NodeVizState::Empty : NodeVizState::Wall;
+        if (perCell) onWallsChanged(n);
+    }
+    if (!perCell) onWallsChanged();
+
+    if (step.hasMarkers) setMarkers(undo ? step.before : step.after);
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << (undo ? "Undo: " : "Redo: ") << step.label;
+    if (!step.flipped.empty()) oss << " (" << step.flipped.size() << " cells)";
+    oss << " | " << m_journal.undoCount() << " undo, " << m_journal.redoCount() << " redo, "
+        << m_journal.bytes() / 1024.0 << " of " << m_journal.budget() / 1024 << " KB";
+    m_status = oss.str();
+}
+
+void GlobalState::undoEdit()
+{
+    EditJournal::Step step;
+    if (m_journal.undo(step)) applyJournalStep(step, true);
+    else m_status = "Nothing to undo.";
+}
+
+void GlobalState::redoEdit()
+{
+    EditJournal::Step step;
+    if (m_journal.redo(step)) applyJournalStep(step, false);
+    else m_status = "Nothing to redo.";
+}
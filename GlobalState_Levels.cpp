@@ -75,7 +75,7 @@ bool GlobalState::loadLevelFromFile(const std::string& relPath)
     }
 
     Node* newStart = nullptr;
-    Node* newGoal = nullptr;
+    std::vector<Node*> newGoals;   // a level may have several G cells
 
     // --- Apply grid ---
     for (int r = 0; r < m_rows; r++)
@@ -107,7 +107,7 @@ bool GlobalState::loadLevelFromFile(const std::string& relPath)
             {
                 n->walkable = true;
                 n->state = NodeVizState::Empty;
-                newGoal = n;
+                newGoals.push_back(n);
             }
             else
             {
@@ -118,7 +118,10 @@ bool GlobalState::loadLevelFromFile(const std::string& relPath)
         }
     }
 
-    if (!newStart || !newGoal)
+    m_journal.clear();   // edits of the previous level cannot be undone into this one
+    onWallsChanged();
+
+    if (!newStart || newGoals.empty())
     {
         m_status = "Level missing S or G: " + relPath;
         return false;
@@ -126,13 +129,21 @@ bool GlobalState::loadLevelFromFile(const std::string& relPath)
 
     // Set start/goal
     m_start = newStart;
-    m_goal = newGoal;
+    m_goal = newGoals.front();
+    m_goals = newGoals;
 
     m_start->state = NodeVizState::Start;
-    m_goal->state = NodeVizState::Goal;
+    for (Node* g : m_goals) g->state = NodeVizState::Goal;
 
     m_currentLevelPath = relPath;
 
+    // --- Optional movement graph next to the level: <name>.graph.txt ---
+    if (!loadGraphLayout(relPath))
+        return false;
+
+    // --- Room/portal decomposition for the room-graph planner ---
+    rebuildRooms();
+
     // --- Solvability check (must have a solution) ---
     computeShortestCorridor();
     if (m_shortestSteps < 0)
@@ -142,6 +153,8 @@ bool GlobalState::loadLevelFromFile(const std::string& relPath)
     }
 
     m_status = "Loaded: " + relPath;
+    if (m_goals.size() > 1)
+        m_status += " (" + std::to_string(m_goals.size()) + " goals, nearest counts)";
     return true;
 }
 
@@ -18,6 +18,39 @@ void GlobalState::update(float dt)
         bool dDown = graphics::getKeyState(graphics::SCANCODE_D);
         bool dPressed = dDown && !m_prevD;
         m_prevD = dDown;
+        bool bDown = graphics::getKeyState(graphics::SCANCODE_B);
+        bool bPressed = bDown && !m_prevB;
+        m_prevB = bDown;
+        bool fDown = graphics::getKeyState(graphics::SCANCODE_F);
+        bool fPressed = fDown && !m_prevF;
+        m_prevF = fDown;
+        bool mDown = graphics::getKeyState(graphics::SCANCODE_M);
+        bool mPressed = mDown && !m_prevM;
+        m_prevM = mDown;
+        bool pDown = graphics::getKeyState(graphics::SCANCODE_P);
+        bool pPressed = pDown && !m_prevP;
+        m_prevP = pDown;
+        bool qDown = graphics::getKeyState(graphics::SCANCODE_Q);
+        bool qPressed = qDown && !m_prevQ;
+        m_prevQ = qDown;
+        bool iDown = graphics::getKeyState(graphics::SCANCODE_I);
+        bool iPressed = iDown && !m_prevI;
+        m_prevI = iDown;
+        bool hDown = graphics::getKeyState(graphics::SCANCODE_H);
+        bool hPressed = hDown && !m_prevH;
+        m_prevH = hDown;
+        bool wDown = graphics::getKeyState(graphics::SCANCODE_W);
+        bool wPressed = wDown && !m_prevW;
+        m_prevW = wDown;
+        bool lDown = graphics::getKeyState(graphics::SCANCODE_L);
+        bool lPressed = lDown && !m_prevL;
+        m_prevL = lDown;
+        bool zDown = graphics::getKeyState(graphics::SCANCODE_Z);
+        bool zPressed = zDown && !m_prevZ;
+        m_prevZ = zDown;
+        bool yDown = graphics::getKeyState(graphics::SCANCODE_Y);
+        bool yPressed = yDown && !m_prevY;
+        m_prevY = yDown;
 
         bool spacePressed = spaceDown && !m_prevSpace;
         bool rPressed = rDown && !m_prevR;
@@ -70,7 +103,7 @@ void GlobalState::update(float dt)
             // If A* is running and player starts editing/drawing, stop A*
             auto stopAStarIfActive = [this]()
                 {
-                    if (m_aState == AStarRunState::Running || m_aState == AStarRunState::Paused) {
+                    if (searchInProgress()) {
                         cancelAStar();
                         resetAttemptTimer();
                         resetScore();
@@ -86,10 +119,12 @@ void GlobalState::update(float dt)
                 {
                     stopAStarIfActive();
                     Node* n = nodeFromMouse(mx, my);
-                    if (n && n != m_start && n != m_goal)
+                    if (n && n != m_start && !isGoal(n))
                     {
                         n->walkable = !n->walkable;
                         n->state = n->walkable ? NodeVizState::Empty : NodeVizState::Wall;
+                        onWallsChanged(n);
+                        m_journal.record({ idx(n) }, nullptr, nullptr, "wall toggle");
                     }
                 }
             }
@@ -187,12 +222,11 @@ void GlobalState::update(float dt)
                 if (n && n->walkable)
                 {
                     clearPlayerPath();
+                    const EditJournal::Markers before = currentMarkers();
 
                     if (shift)
                     {
-                        if (m_goal) m_goal->state = NodeVizState::Empty;
-                        m_goal = n;
-                        m_goal->state = NodeVizState::Goal;
+                        setSingleGoal(n);
                     }
                     else
                     {
@@ -200,6 +234,9 @@ void GlobalState::update(float dt)
                         m_start = n;
                         m_start->state = NodeVizState::Start;
                     }
+
+                    const EditJournal::Markers after = currentMarkers();
+                    m_journal.record({}, &before, &after, shift ? "Goal move" : "Start move");
                 }
             }
         }
@@ -233,7 +270,7 @@ void GlobalState::update(float dt)
 
             if (m_drawMode)
             {
-                if (m_aState == AStarRunState::Running || m_aState == AStarRunState::Paused)
+                if (searchInProgress())
                     cancelAStar();
 
                 clearPlayerPath();
@@ -251,19 +288,118 @@ void GlobalState::update(float dt)
             m_status = "Cleared. LMB: wall | RMB: start | Shift+RMB: goal | SPACE: A* | C: clear";
         }
 
-        if (graphics::getKeyState(graphics::SCANCODE_I))
+        if (hPressed)
+        {
+            toggleExactHeuristic();
+        }
+
+        if (wPressed)
+        {
+            const bool shift = graphics::getKeyState(graphics::SCANCODE_LSHIFT) ||
+                graphics::getKeyState(graphics::SCANCODE_RSHIFT);
+            if (shift)
+            {
+                std::string path = m_currentLevelPath.empty() ? "assets/levels/custom.txt" : m_currentLevelPath;
+                const size_t dot = path.rfind(".txt");
+                path = (dot == std::string::npos ? path : path.substr(0, dot)) + ".impact.txt";
+                exportWallImpact(path);
+            }
+            else
+            {
+                toggleWallImpact();
+            }
+        }
+
+        if (lPressed)
+        {
+            runLevelAnalytics();
+        }
+
+        if ((zPressed || yPressed) && !m_isDrawing)
+        {
+            const bool ctrl = graphics::getKeyState(graphics::SCANCODE_LCTRL) ||
+                graphics::getKeyState(graphics::SCANCODE_RCTRL);
+            const bool shift = graphics::getKeyState(graphics::SCANCODE_LSHIFT) ||
+                graphics::getKeyState(graphics::SCANCODE_RSHIFT);
+            if (ctrl && zPressed && !shift) undoEdit();
+            else if (ctrl) redoEdit();   // Ctrl+Y or Ctrl+Shift+Z
+        }
+
+        if (m_impactOn)
+        {
+            computeWallImpact();   // no-op unless walls, Start or goals changed
+        }
+
+        if (iPressed && !startBackgroundAStar())
         {
             bool ok = runAStar();
-            m_status = ok ? "Instant A*: Path found!" : "Instant A*: No path.";
+            m_status = "Instant " + engineName() + (ok ? ": Path found! " : ": No path. ") + searchStats();
+        }
+
+        if (m_bgSearch.active())
+        {
+            drainBackgroundAStar(dt);
+        }
+
+        if (bPressed)
+        {
+            const bool shift = graphics::getKeyState(graphics::SCANCODE_LSHIFT) ||
+                graphics::getKeyState(graphics::SCANCODE_RSHIFT);
+            if (shift) runParallelAStarBenchmark();
+            else runBatchBenchmark();
+        }
+
+        if (fPressed)
+        {
+            toggleCrowd();
+        }
+
+        if (m_crowdOn)
+        {
+            updateCrowd(dt);
+        }
+
+        if (mPressed)
+        {
+            cycleMapfMode();
+        }
+
+        if (m_mapfMode != MapfMode::Off)
+        {
+            updateMapf(dt);
+        }
+
+        if (pPressed)
+        {
+            togglePatrols();
+        }
+
+        if (m_patrolOn)
+        {
+            updatePatrols(dt);
+        }
+
+        if (qPressed)
+        {
+            togglePathRequests();
+        }
+
+        if (m_pathsOn)
+        {
+            updatePathRequests(dt);
         }
 
         if (m_aState == AStarRunState::Running)
         {
+            // Expansions owed since the last frame, within the per-frame time budget
             m_stepAccumMs += dt;
-            if (m_stepAccumMs >= m_stepDelayMs)
+            int owed = 0;   // 0 = no expansion limit ("max" speed)
+            if (m_stepDelayMs > 0.0f)
             {
-                m_stepAccumMs -= m_stepDelayMs;
-                stepAStar(); // one expansion per step
+                owed = (int)(m_stepAccumMs / m_stepDelayMs);
+                m_stepAccumMs -= owed * m_stepDelayMs;
             }
+            if (owed > 0 || m_stepDelayMs <= 0.0f)
+                stepAStar(owed, m_stepBudgetUs);
         }
 }
@@ -0,0 +1,144 @@
+#include "GlobalState.h"
+#include "graphics.h"
+#include <chrono>
+#include <cstdlib>
+
+void GlobalState::pickMapfAgents(int count)
+{
+    // Distinct random starts and goals among the free cells
+    std::vector<int> freeCells;
+    for (Node* n : m_grid.getAllNodes())
+        if (n->walkable) freeCells.push_back(idx(n));
+
+    for (int i = (int)freeCells.size() - 1; i > 0; i--)
+        std::swap(freeCells[i], freeCells[rand() % (i + 1)]);
+
+    count = std::min(count, (int)freeCells.size() / 2);
+    m_mapfAgents.assign(count, {});
+    for (int i = 0; i < count; i++)
+    {
+        m_mapfAgents[i].start = freeCells[2 * i];
+        m_mapfAgents[i].goal = freeCells[2 * i + 1];
+    }
+}
+
+void GlobalState::cycleMapfMode()
+{
+    switch (m_mapfMode)
+    {
+    case MapfMode::Off:         m_mapfMode = MapfMode::Cooperative; pickMapfAgents(24); break;
+    case MapfMode::Cooperative: m_mapfMode = MapfMode::CBS;         pickMapfAgents(6);  break;
+    default:                    m_mapfMode = MapfMode::Off;         break;
+    }
+
+    if (m_mapfMode == MapfMode::Off)
+    {
+        m_mapfAgents.clear();
+        m_status = "Multi-agent: off.";
+        return;
+    }
+    planMapf();
+}
+
+void GlobalState::planMapf()
+{
+    m_mapfDirty = false;
+    m_mapfClock = 0.0f;
+
+    // Agents whose start or goal was walled over get new cells
+    for (const MultiAgentPlanner::Agent& a : m_mapfAgents)
+    {
+        const std::vector<Node*>& nodes = m_grid.getAllNodes();
+        if (a.start >= (int)nodes.size() || a.goal >= (int)nodes.size() ||
+            !nodes[a.start]->walkable || !nodes[a.goal]->walkable)
+        {
+            pickMapfAgents((int)m_mapfAgents.size());
+            break;
+        }
+    }
+
+    const GridSnapshot snap = gridSnapshot();
+    const auto method = (m_mapfMode == MapfMode::CBS) ? MultiAgentPlanner::Method::CBS : MultiAgentPlanner::Method::Cooperative;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    m_mapf.plan(snap, m_mapfAgents, method);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    int routed = 0;
+    for (const std::vector<int>& p : m_mapf.paths())
+        if (!p.empty()) routed++;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "Multi-agent " << (m_mapf.usedMethod() == MultiAgentPlanner::Method::CBS ? "CBS" : "cooperative A*")
+        << ": " << routed << "/" << m_mapfAgents.size() << " agents in " << ms << " ms"
+        << " (sum of costs " << m_mapf.sumOfCosts() << ", makespan " << m_mapf.makespan()
+        << ", " << m_mapf.expandedCount() << " expanded";
+    if (m_mapf.usedMethod() == MultiAgentPlanner::Method::CBS)
+        oss << ", " << m_mapf.cbsNodes() << " CT nodes";
+    oss << ") M: next mode";
+    m_status = oss.str();
+}
+
+void GlobalState::updateMapf(float dtMs)
+{
+    if (m_mapfDirty)
+        planMapf();
+
+    // Replay the routes in a loop, a few timesteps per second
+    m_mapfClock += dtMs / 1000.0f * 4.0f;
+    if (m_mapfClock > m_mapf.makespan() + 2.0f)
+        m_mapfClock = 0.0f;
+}
+
+void GlobalState::drawMapf() const
+{
+    if (m_mapfMode == MapfMode::Off) return;
+
+    auto centerX = [&](int cell) { return m_originX + (cell % m_cols + 0.5f) * m_cell; };
+    auto centerY = [&](int cell) { return m_originY + (cell / m_cols + 0.5f) * m_cell; };
+
+    const std::vector<std::vector<int>>& paths = m_mapf.paths();
+    for (int i = 0; i < (int)paths.size() && i < (int)m_mapfAgents.size(); i++)
+    {
+        // Spread the agent colours around the hue circle
+        const float hue = (float)i / (float)paths.size() * 6.0f;
+        const float x = 1.0f - std::fabs(std::fmod(hue, 2.0f) - 1.0f);
+        float rgb[3] = { 0.0f, 0.0f, 0.0f };
+        switch ((int)hue % 6)
+        {
+        case 0: rgb[0] = 1; rgb[1] = x; break;
+        case 1: rgb[0] = x; rgb[1] = 1; break;
+        case 2: rgb[1] = 1; rgb[2] = x; break;
+        case 3: rgb[1] = x; rgb[2] = 1; break;
+        case 4: rgb[0] = x; rgb[2] = 1; break;
+        default: rgb[0] = 1; rgb[2] = x; break;
+        }
+
+        graphics::Brush br;
+        br.outline_opacity = 0.8f;
+        br.outline_width = 2.0f;
+        br.fill_opacity = 0.9f;
+        for (int k = 0; k < 3; k++) br.outline_color[k] = br.fill_color[k] = rgb[k];
+
+        const MultiAgentPlanner::Agent& a = m_mapfAgents[i];
+        graphics::Brush goal = br;
+        goal.fill_opacity = 0.0f;
+        graphics::drawRect(centerX(a.goal), centerY(a.goal), m_cell * 0.6f, m_cell * 0.6f, goal);
+
+        const std::vector<int>& p = paths[i];
+        if (p.empty()) continue;
+
+        for (size_t t = 1; t < p.size(); t++)
+            if (p[t] != p[t - 1])
+                graphics::drawLine(centerX(p[t - 1]), centerY(p[t - 1]), centerX(p[t]), centerY(p[t]), br);
+
+        // Agent position at the current animation time
+        const int t0 = std::min((int)m_mapfClock, (int)p.size() - 1);
+        const int t1 = std::min(t0 + 1, (int)p.size() - 1);
+        const float f = (t0 == (int)p.size() - 1) ? 0.0f : m_mapfClock - (float)t0;
+        const float ax = centerX(p[t0]) + (centerX(p[t1]) - centerX(p[t0])) * f;
+        const float ay = centerY(p[t0]) + (centerY(p[t1]) - centerY(p[t0])) * f;
+        graphics::drawDisk(ax, ay, m_cell * 0.3f, br);
+    }
+}
@@ -0,0 +1,131 @@
+#include "GlobalState.h"
+#include "graphics.h"
+#include <cstdlib>
+
+void GlobalState::togglePathRequests()
+{
+    m_pathsOn = !m_pathsOn;
+    m_pathRequests.clear();
+    m_pathMain = -1;
+
+    if (!m_pathsOn || !m_start || !m_goal)
+    {
+        m_pathsOn = false;
+        m_paths.clear();
+        m_status = "Path requests: off.";
+        return;
+    }
+
+    m_paths.reset(m_grid);
+    m_pathsStale = false;
+    m_pathSubmitAccumMs = 0.0f;
+
+    // The background load goes in first so the main request has to jump the queue
+    submitBackgroundRequests(60);
+    m_pathMain = m_paths.submit(m_start, m_goal, 10);
+
+    m_status = "Path requests: Start -> Goal at high priority over 60 background requests (Q: off)";
+}
+
+void GlobalState::submitBackgroundRequests(int count)
+{
+    std::vector<Node*> freeNodes;
+    for (Node* n : m_grid.getAllNodes())
+        if (n->walkable) freeNodes.push_back(n);
+    if (freeNodes.size() < 2) return;
+
+    // Every fourth request repeats an earlier pair and shares its search
+    for (int i = 0; i < count; i++)
+    {
+        PathService::Handle h;
+        if (i % 4 == 3 && !m_pathRequests.empty())
+        {
+            const PathService::Handle prev = m_pathRequests[rand() % m_pathRequests.size()];
+            h = m_paths.submit(m_paths.requestStart(prev), m_paths.requestGoal(prev), 1);
+        }
+        else
+        {
+            h = m_paths.submit(freeNodes[rand() % freeNodes.size()], freeNodes[rand() % freeNodes.size()], 0);
+        }
+        m_pathRequests.push_back(h);
+    }
+
+    // The demo keeps submitting: drop the oldest handles so their jobs and paths are recycled
+    const int excess = (int)m_pathRequests.size() - PATH_REQUESTS_KEPT;
+    if (excess > 0)
+    {
+        for (int i = 0; i < excess; i++)
+            m_paths.cancel(m_pathRequests[i]);
+        m_pathRequests.erase(m_pathRequests.begin(), m_pathRequests.begin() + excess);
+    }
+}
+
+void GlobalState::updatePathRequests(float dtMs)
+{
+    // A toggled wall may have cut the main route: ask again
+    if (m_pathsStale)
+    {
+        m_pathsStale = false;
+        m_paths.cancel(m_pathMain);
+        m_pathMain = m_paths.submit(m_start, m_goal, 10);
+    }
+
+    m_pathSubmitAccumMs += dtMs;
+    if (m_pathSubmitAccumMs >= 1000.0f)
+    {
+        m_pathSubmitAccumMs = 0.0f;
+        submitBackgroundRequests(10);
+    }
+
+    m_paths.runFrame(m_pathBudgetUs);
+
+    int done = 0;
+    for (PathService::Handle h : m_pathRequests)
+        if (m_paths.done(h)) done++;
+
+    const PathService::Status mainStatus = m_paths.status(m_pathMain);
+    const char* mainText = (mainStatus == PathService::Status::Found) ? "found" :
+        (mainStatus == PathService::Status::NoPath) ? "no path" : "searching";
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(0)
+        << "Requests: main " << mainText
+        << " | background " << done << "/" << m_pathRequests.size()
+        << " | queued " << m_paths.pendingCount()
+        << " | coalesced " << m_paths.coalescedCount()
+        << " | cached " << m_paths.pathBytes() << " B"
+        << " | frame " << m_paths.lastFrameExpansions() << " exp in " << m_paths.lastFrameMicros()
+        << "/" << m_pathBudgetUs << " us";
+    m_status = oss.str();
+}
+
+void GlobalState::drawPathRequests() const
+{
+    if (!m_pathsOn) return;
+
+    auto centerX = [&](int cell) { return m_originX + (cell % m_cols + 0.5f) * m_cell; };
+    auto centerY = [&](int cell) { return m_originY + (cell / m_cols + 0.5f) * m_cell; };
+    auto drawRoute = [&](const Path& route, const graphics::Brush& br)
+        {
+            const std::vector<int>& cells = route.cells();
+            for (size_t i = 1; i < cells.size(); i++)
+                graphics::drawLine(centerX(cells[i - 1]), centerY(cells[i - 1]), centerX(cells[i]), centerY(cells[i]), br);
+        };
+
+    graphics::Brush faint;
+    faint.outline_opacity = 0.25f;
+    faint.outline_width = 1.5f;
+    faint.outline_color[0] = 0.70f;
+    faint.outline_color[1] = 0.55f;
+    faint.outline_color[2] = 0.95f;
+    for (PathService::Handle h : m_pathRequests)
+        drawRoute(m_paths.path(h), faint);
+
+    graphics::Brush main;
+    main.outline_opacity = 0.95f;
+    main.outline_width = 3.5f;
+    main.outline_color[0] = 0.70f;
+    main.outline_color[1] = 0.40f;
+    main.outline_color[2] = 1.00f;
+    drawRoute(m_paths.path(m_pathMain), main);
+}
@@ -0,0 +1,154 @@
+#include "GlobalState.h"
+#include "graphics.h"
+#include <chrono>
+#include <cstdlib>
+
+void GlobalState::togglePatrols()
+{
+    m_patrolOn = !m_patrolOn;
+    if (!m_patrolOn || !m_start || !m_goal)
+    {
+        m_patrolOn = false;
+        m_patrol.clear();
+        m_status = "Patrols: off.";
+        return;
+    }
+
+    m_patrol.reset(m_grid, idx(m_start), idx(m_goal));
+    m_patrolTickAccumMs = 0.0f;
+    m_patrolRuns = 0;
+
+    std::vector<int> freeCells;
+    for (Node* n : m_grid.getAllNodes())
+        if (n->walkable && n != m_start && !isGoal(n)) freeCells.push_back(idx(n));
+
+    // Each patrol walks back and forth along a shortest path of 6..20 cells.
+    // Patrols walk grid moves, so imported arcs of a level graph are left out.
+    CsrGraph gridMoves;
+    const CsrGraph* moves = &ensureGraph();
+    if (!m_layout.empty())
+    {
+        gridMoves = CsrGraph::fromGrid(m_grid);
+        moves = &gridMoves;
+    }
+
+    const int count = std::max(4, (int)freeCells.size() / 120);
+    std::vector<int> anchors;
+    for (int i = 0; i < count && !freeCells.empty(); i++)
+        anchors.push_back(freeCells[rand() % freeCells.size()]);
+
+    // 64 anchors per BFS pass, 20 layers deep; each lane keeps the cells it reached
+    std::vector<std::vector<std::pair<int, int>>> reached(BitParallelBfs::LANES);
+    std::vector<int> dist(m_rows * m_cols, -1);
+    for (size_t first = 0; first < anchors.size(); first += BitParallelBfs::LANES)
+    {
+        const int lanes = (int)std::min<size_t>(BitParallelBfs::LANES, anchors.size() - first);
+        for (auto& r : reached) r.clear();
+        m_multiBfs.run(*moves, anchors.data() + first, lanes, 20,
+            [&](int lane, int node, int depth) { reached[lane].push_back({ node, depth }); });
+
+        for (int lane = 0; lane < lanes; lane++)
+        {
+            const int a = anchors[first + lane];
+            std::vector<int> ends;
+            for (const auto& nd : reached[lane])
+            {
+                dist[nd.first] = nd.second;
+                const Node* n = m_grid.getAllNodes()[nd.first];
+                if (nd.second >= 6 && n != m_start && !isGoal(n)) ends.push_back(nd.first);
+            }
+
+            if (!ends.empty())
+            {
+                std::vector<int> route;
+                for (int c = ends[rand() % ends.size()]; ; )
+                {
+                    route.push_back(c);
+                    if (c == a) break;
+                    for (int e = moves->firstArc(c); e < moves->lastArc(c); e++)
+                    {
+                        if (dist[moves->target(e)] == dist[c] - 1) { c = moves->target(e); break; }
+                    }
+                }
+                m_patrol.addPatrol(route);
+            }
+
+            for (const auto& nd : reached[lane])
+                dist[nd.first] = -1;
+        }
+    }
+
+    m_status = "Patrols: " + std::to_string(m_patrol.patrols().size()) +
+        " moving walls, runner replans within " + std::to_string(m_patrolBudget) + " expansions/frame (P: off)";
+}
+
+void GlobalState::updatePatrols(float dtMs)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+
+    m_patrolTickAccumMs += dtMs;
+    while (m_patrolTickAccumMs >= m_patrolTickMs)
+    {
+        m_patrolTickAccumMs -= m_patrolTickMs;
+        m_patrol.tick();
+
+        if (m_patrol.arrived())
+        {
+            m_patrolRuns++;
+            m_patrol.restartRunner(idx(m_start));
+        }
+    }
+
+    m_patrol.frame(m_patrolBudget);
+
+    m_patrolFrameUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(0)
+        << "Patrols: " << m_patrol.patrols().size() << " | runs " << m_patrolRuns
+        << " | replans " << m_patrol.replans()
+        << " (last " << m_patrol.lastReplanExpansions() << " exp over " << m_patrol.lastReplanFrames() << " frames)"
+        << (m_patrol.searching() ? " | replanning" : "")
+        << " | frame " << m_patrolFrameUs << " us";
+    m_status = oss.str();
+}
+
+void GlobalState::drawPatrols() const
+{
+    if (!m_patrolOn || !m_patrol.active()) return;
+
+    auto centerX = [&](int cell) { return m_originX + (cell % m_cols + 0.5f) * m_cell; };
+    auto centerY = [&](int cell) { return m_originY + (cell / m_cols + 0.5f) * m_cell; };
+
+    // Remaining route
+    graphics::Brush line;
+    line.outline_opacity = 0.85f;
+    line.outline_width = 3.0f;
+    line.outline_color[0] = 0.20f;
+    line.outline_color[1] = 0.85f;
+    line.outline_color[2] = 0.95f;
+
+    const std::vector<int> route = m_patrol.remainingRoute();
+    for (size_t i = 1; i < route.size(); i++)
+        graphics::drawLine(centerX(route[i - 1]), centerY(route[i - 1]), centerX(route[i]), centerY(route[i]), line);
+
+    // Patrols
+    graphics::Brush wall;
+    wall.fill_opacity = 0.9f;
+    wall.outline_opacity = 0.0f;
+    wall.fill_color[0] = 0.85f;
+    wall.fill_color[1] = 0.20f;
+    wall.fill_color[2] = 0.20f;
+    for (const PatrolReplanner::Patrol& p : m_patrol.patrols())
+        graphics::drawRect(centerX(p.cell), centerY(p.cell), m_cell * 0.8f, m_cell * 0.8f, wall);
+
+    // Runner
+    graphics::Brush runner;
+    runner.fill_opacity = 1.0f;
+    runner.outline_opacity = 0.0f;
+    runner.fill_color[0] = 0.20f;
+    runner.fill_color[1] = 0.85f;
+    runner.fill_color[2] = 0.95f;
+    const int cell = m_patrol.runnerCell();
+    graphics::drawDisk(centerX(cell), centerY(cell), m_cell * 0.32f, runner);
+}
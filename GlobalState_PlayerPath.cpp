@@ -9,7 +9,7 @@ void GlobalState::clearPlayerPath()
     for (Node* n : m_playerPath)
     {
         if (!n) continue;
-        if (n == m_start || n == m_goal) continue;
+        if (n == m_start || isGoal(n)) continue;
         if (!n->walkable) continue; // wall stays wall
         // Only clear if it is player path
         if (n->state == NodeVizState::PlayerPath)
@@ -19,12 +19,10 @@ void GlobalState::clearPlayerPath()
     m_lastDrawn = nullptr;
 }
 
-bool GlobalState::isAdjacent(const Node* a, const Node* b) const
+bool GlobalState::isAdjacent(const Node* a, const Node* b)
 {
     if (!a || !b) return false;
-    const int dr = std::abs(a->row - b->row);
-    const int dc = std::abs(a->col - b->col);
-    return (dr + dc) == 1; // 4-neighborhood
+    return ensureGraph().arcWeight(idx(a), idx(b)) >= 0;   // 4-neighbourhood, or an arc of the level graph
 }
 
 void GlobalState::beginPlayerDrawing()
@@ -67,10 +65,10 @@ bool GlobalState::appendPlayerPath(Node* n)
     m_playerPath.push_back(n);
 
     // paint it
-    if (n != m_goal && n != m_start)
+    if (!isGoal(n) && n != m_start)
         n->state = NodeVizState::PlayerPath;
 
-    if (n == m_goal)
+    if (isGoal(n))
         m_status = "Player path reached GOAL!";
 
     return true;
@@ -84,7 +82,7 @@ void GlobalState::clearInvalidMarks()
     {
         if (!n) continue;
         if (n == m_start) { n->state = NodeVizState::Start; continue; }
-        if (n == m_goal) { n->state = NodeVizState::Goal;  continue; }
+        if (isGoal(n)) { n->state = NodeVizState::Goal;  continue; }
         if (!n->walkable) { n->state = NodeVizState::Wall;  continue; }
 
         if (n->state == NodeVizState::PlayerInvalid)
@@ -97,7 +95,7 @@ void GlobalState::markInvalidNode(int index)
     if (index < 0 || index >= (int)m_playerPath.size()) return;
     Node* n = m_playerPath[index];
     if (!n) return;
-    if (n == m_start || n == m_goal) return;
+    if (n == m_start || isGoal(n)) return;
     if (!n->walkable) return;
 
     n->state = NodeVizState::PlayerInvalid;
@@ -161,7 +159,7 @@ GlobalState::PlayerPathValidation GlobalState::validatePlayerPath()
         }
     }
 
-    if (m_playerPath.back() == m_goal)
+    if (isGoal(m_playerPath.back()))
     {
         m_pathComplete = true;
         return PlayerPathValidation::ValidToGoal;
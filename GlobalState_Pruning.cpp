@@ -0,0 +1,24 @@
+#include "GlobalState.h"
+
+bool GlobalState::buildPruneMask()
+{
+    // Dead ends are found on grid moves; a teleporter can make any of them a shortcut
+    if (!m_layout.empty())
+    {
+        m_pruneMask.assign(m_rows * m_cols, 1);
+        return true;
+    }
+
+    if (m_prunerDirty)
+    {
+        m_pruner.build(m_grid);
+        m_prunerDirty = false;
+    }
+
+    // If Start and Goal are disconnected there is nothing to keep; fall back to
+    // an unrestricted search so the failure is reported the usual way.
+    const std::vector<const Node*> goals(m_goals.begin(), m_goals.end());
+    if (!m_pruner.buildMask(m_start, goals, m_pruneMask))
+        m_pruneMask.assign(m_rows * m_cols, 1);
+    return true;
+}
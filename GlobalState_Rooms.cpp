@@ -0,0 +1,58 @@
+#include "GlobalState.h"
+#include "graphics.h"
+
+void GlobalState::rebuildRooms()
+{
+    m_rooms.build(m_grid);
+    m_roomsDirty = false;
+}
+
+bool GlobalState::planRoomRoute()
+{
+    if (m_roomsDirty) rebuildRooms();
+
+    // An empty mask (no route) lets A* fail immediately with NoPath
+    return m_rooms.plan(m_start, m_goal, m_roomMask);
+}
+
+void GlobalState::drawRoomOverlay() const
+{
+    const SearchEngine engine = activeEngine();
+    const bool rsr = (engine == SearchEngine::RSR) && !m_rsrDirty && !m_rsr.empty();
+    const bool rooms = (engine == SearchEngine::Rooms) && !m_roomsDirty && !m_rooms.empty();
+    if (!rsr && !rooms) return;
+
+    graphics::Brush br;
+    br.fill_opacity = 0.0f;
+    br.outline_opacity = 0.35f;
+    br.outline_width = 1.5f;
+    br.outline_color[0] = 0.95f;
+    br.outline_color[1] = 0.55f;
+    br.outline_color[2] = 0.15f;
+
+    auto drawRoom = [&](const RoomGraph::Room& room)
+        {
+            const float w = (room.c1 - room.c0 + 1) * m_cell;
+            const float h = (room.r1 - room.r0 + 1) * m_cell;
+            const float cx = m_originX + room.c0 * m_cell + w * 0.5f;
+            const float cy = m_originY + room.r0 * m_cell + h * 0.5f;
+            graphics::drawRect(cx, cy, w - 2.0f, h - 2.0f, br);
+        };
+
+    if (rsr)
+    {
+        // RSR only searches rectangle perimeters; outline the current cover
+        for (int id = 0; id < (int)m_rsr.rects().size(); id++)
+            if (m_rsr.rectAlive(id)) drawRoom(m_rsr.rects()[id]);
+        return;
+    }
+
+    for (const RoomGraph::Room& room : m_rooms.rooms())
+        drawRoom(room);
+
+    // Rooms on the last planned route get a stronger outline
+    br.outline_opacity = 0.9f;
+    br.outline_width = 2.5f;
+    for (int id : m_rooms.lastRoute())
+        drawRoom(m_rooms.rooms()[id]);
+}
@@ -15,60 +15,83 @@ void GlobalState::resetScore()
     m_overlap = 0.0f;
     m_efficiency = 0.0f;
     m_score = 0;
+    m_matchedRoute = -1;
 }
 
-void GlobalState::computeBfsDistances(Node* src, std::vector<int>& dist)
+void GlobalState::computeBfsDistances(Node* src, std::vector<int>& dist, const std::vector<char>* mask)
 {
-    dist.assign(m_rows * m_cols, INF);
-    if (!src) return;
+    computeBfsDistances(std::vector<Node*>{ src }, dist, mask);
+}
+
+void GlobalState::computeBfsDistances(const std::vector<Node*>& sources, std::vector<int>& dist, const std::vector<char>* mask)
+{
+    // Multi-source: every source starts at distance 0, dist[] ends up as the distance to the nearest one.
+    // Runs on the movement graph, so imported arcs (and their weights) count like grid moves.
+    std::vector<int> cells;
+    for (const Node* src : sources)
+        if (src) cells.push_back(idx(src));
+    ensureGraph().distances(cells, dist, INF, mask);
+}
 
-    std::queue<Node*> q;
-    dist[idx(src)] = 0;
-    q.push(src);
+const std::vector<int>& GlobalState::distGoal()
+{
+    // The flow field follows grid moves only; with imported arcs the distances come from the graph
+    if (m_layout.empty())
+    {
+        ensureFlowField();
+        return m_flow.distances();
+    }
 
-    while (!q.empty())
+    ensureGraph();
+    if (m_layoutGoalDirty || m_layoutGoalDistFor != m_goals)
     {
-        Node* cur = q.front();
-        q.pop();
-
-        const int curd = dist[idx(cur)];
-
-        for (Node* nb : cur->neighbors)
-        {
-            if (!nb || !nb->walkable) continue;
-
-            const int nbIdx = idx(nb);
-            if (dist[nbIdx] > curd + 1)
-            {
-                dist[nbIdx] = curd + 1;
-                q.push(nb);
-            }
-        }
+        computeGoalDistances(m_layoutGoalDist);
+        m_layoutGoalDistFor = m_goals;
+        m_layoutGoalDirty = false;
     }
+    return m_layoutGoalDist;
 }
 
 bool GlobalState::computeShortestCorridor()
 {
     if (!m_start || !m_goal) return false;
 
-    computeBfsDistances(m_start, m_distStart);
-    computeBfsDistances(m_goal, m_distGoal);
+    // No walls in the Start/Goal box (one goal, grid moves): every monotone route is
+    // shortest and nothing outside the box can be on one, so no BFS is needed
+    const int r0 = std::min(m_start->row, m_goal->row), r1 = std::max(m_start->row, m_goal->row);
+    const int c0 = std::min(m_start->col, m_goal->col), c1 = std::max(m_start->col, m_goal->col);
+    if (m_goals.size() == 1 && m_layout.empty() && !m_grid.anyWall(r0, c0, r1, c1))
+    {
+        m_shortestSteps = (r1 - r0) + (c1 - c0);
+        m_onShortest.assign(m_rows * m_cols, 0);
+        for (int r = r0; r <= r1; r++)
+            std::fill(m_onShortest.begin() + r * m_cols + c0, m_onShortest.begin() + r * m_cols + c1 + 1, 1);
+        return true;
+    }
+
+    // Pruned dead ends can never hold an optimal path, so the BFS skips them
+    const std::vector<char>* mask = (m_pruneDeadEnds && buildPruneMask()) ? &m_pruneMask : nullptr;
+
+    computeBfsDistances(m_start, m_distStart, mask);
 
-    const int goalI = idx(m_goal);
-    if (m_distStart[goalI] >= INF)
+    // Distance to the nearest goal; with one goal this is just dist(Start, Goal).
+    // Unmasked, but a pruned cell can never satisfy the corridor test below anyway.
+    const std::vector<int>& dGoal = distGoal();
+    const int startI = idx(m_start);
+    if (dGoal[startI] >= FlowField::UNREACHABLE)
     {
         m_shortestSteps = -1;
         m_onShortest.assign(m_rows * m_cols, 0);
         return false;
     }
 
-    m_shortestSteps = m_distStart[goalI];
+    m_shortestSteps = dGoal[startI];
 
     m_onShortest.assign(m_rows * m_cols, 0);
     for (int i = 0; i < (int)m_onShortest.size(); i++)
     {
-        if (m_distStart[i] >= INF || m_distGoal[i] >= INF) continue;
-        if (m_distStart[i] + m_distGoal[i] == m_shortestSteps)
+        if (m_distStart[i] >= INF || dGoal[i] >= FlowField::UNREACHABLE) continue;
+        if (m_distStart[i] + dGoal[i] == m_shortestSteps)
             m_onShortest[i] = 1; // this cell lies on at least one optimal path
     }
 
@@ -91,22 +114,35 @@ bool GlobalState::computeScore()
         return false;
     }
 
-    // Steps are edges between nodes
-    m_playerSteps = (int)m_playerPath.size() - 1;
-    if (m_playerSteps < 0) m_playerSteps = 0;
+    const Path player = Path::fromNodes(m_playerPath, m_cols);
 
-    // Corridor overlap: fraction of player's visited cells that lie on ANY shortest path corridor
-    int hits = 0;
-    for (Node* n : m_playerPath)
+    // Steps are edges between nodes; weighted arcs of an imported graph count their cost
+    m_playerSteps = player.length();
+    if (ensureGraph().weighted())
     {
-        if (!n) continue;
-        if (m_onShortest[idx(n)]) hits++;
+        m_playerSteps = 0;
+        for (size_t i = 1; i < player.cells().size(); i++)
+            m_playerSteps += std::max(0, m_graph.arcWeight(player.cells()[i - 1], player.cells()[i]));
     }
+
+    // Corridor overlap: fraction of player's visited cells that lie on ANY shortest path corridor
+    const int hits = player.overlap(m_onShortest);
     m_onShortestCount = hits;
 
     // Overlap as "how cleanly you stayed on the optimal corridor"
     m_overlap = (m_playerPath.empty()) ? 0.0f : (float)hits / (float)m_playerPath.size();
 
+    // A path that follows one of the near-optimal alternatives is credited as if
+    // that route were the corridor, even where it leaves the shortest ones
+    // (grid moves only: with an imported graph the corridor alone decides)
+    if (m_layout.empty())
+        m_routes.build(gridSnapshot(), idx(m_start), distGoal(), FlowField::UNREACHABLE, m_routeOptions);
+    else
+        m_routes.clear();
+    float routeMatch = 0.0f;
+    m_matchedRoute = m_routes.bestMatch(player, m_routeMatchMin, &routeMatch);
+    if (m_matchedRoute >= 0) m_overlap = std::max(m_overlap, routeMatch);
+
     // Efficiency: 1 if you matched shortest steps, smaller if longer
     m_efficiency = (m_shortestSteps <= 0) ? 1.0f :
         (float)m_shortestSteps / (float)std::max(m_shortestSteps, m_playerSteps);
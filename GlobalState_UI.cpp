@@ -92,7 +92,7 @@ void GlobalState::setupUI()
             if (m_drawMode)
             {
                 // safest: stop A* visuals so colors don't mix
-                if (m_aState == AStarRunState::Running || m_aState == AStarRunState::Paused)
+                if (searchInProgress())
                     cancelAStar();
 
                 clearPlayerPath();
@@ -157,10 +157,10 @@ void GlobalState::setupUI()
     Button* speedBtn = addBtnAt(sx1, ySpeedRandom, speedRandomW, speedRandomH, "Speed x1", "orange", []() {});
     speedBtn->onClick = [this, speedBtn]()
         {
-            m_speedIndex = (m_speedIndex + 1) % 7;
+            m_speedIndex = (m_speedIndex + 1) % 9;
             m_stepDelayMs = SPEED_LEVELS[m_speedIndex];
 
-            static const char* labels[7] = { "x0.5", "x0.75", "x1", "x1.5", "x2", "x3", "x5" };
+            static const char* labels[9] = { "x0.5", "x0.75", "x1", "x1.5", "x2", "x3", "x5", "x25", "max" };
             speedBtn->text = std::string("Speed ") + labels[m_speedIndex];
         };
 
@@ -168,14 +168,18 @@ void GlobalState::setupUI()
         {
             cancelAStar();
             resetScore();
+            std::vector<int> flipped;   // for undo: only the cells that changed
             for (Node* n : m_grid.getAllNodes())
             {
-                if (n == m_start || n == m_goal) continue;
+                if (n == m_start || isGoal(n)) continue;
                 // 20% walls
                 bool wall = (rand() % 100) < 20;
+                if (n->walkable == wall) flipped.push_back(idx(n));
                 n->walkable = !wall;
                 n->state = wall ? NodeVizState::Wall : NodeVizState::Empty;
             }
+            onWallsChanged();
+            m_journal.record(flipped, nullptr, nullptr, "Random Walls");
         });
 
     by += (speedRandomH + gap);
@@ -267,6 +271,108 @@ void GlobalState::setupUI()
 
     by += (toggleH + gap);
 
+    // --- Search engine row ---
+    float engineH = bh * 0.95f;
+    float engineW = (bw - gap) / 2.0f;
+
+    float engineLeftEdge = bx - bw * 0.5f;
+    float ex1 = engineLeftEdge + engineW * 0.5f;
+
+    float yEngine = by;
+
+    Button* engineBtn = addBtnAt(ex1, yEngine, engineW, engineH, "Engine: A*", "blue", []() {});
+    engineBtn->padX = 10.0f;
+    engineBtn->onClick = [this, engineBtn]()
+        {
+            cancelAStar();
+            resetScore();
+
+            switch (m_engine)
+            {
+            case SearchEngine::AStar: m_engine = SearchEngine::Rooms; break;
+            case SearchEngine::Rooms: m_engine = SearchEngine::RSR;   break;
+            case SearchEngine::RSR:   m_engine = SearchEngine::Fringe; break;
+            case SearchEngine::Fringe: m_engine = SearchEngine::Weighted; break;
+            case SearchEngine::Weighted: m_engine = SearchEngine::Anytime; break;
+            case SearchEngine::Anytime: m_engine = SearchEngine::Theta; break;
+            default:                  m_engine = SearchEngine::AStar; break;
+            }
+            engineBtn->text = "Engine: " + engineName();
+            m_status = "Search engine: " + engineName();
+        };
+
+    Button* pruneBtn = addBtnAt(ex1 + engineW + gap, yEngine, engineW, engineH, "Prune ON", "blue", []() {});
+    pruneBtn->padX = 10.0f;
+    pruneBtn->onClick = [this, pruneBtn]()
+        {
+            cancelAStar();
+            resetScore();
+
+            m_pruneDeadEnds = !m_pruneDeadEnds;
+            pruneBtn->text = std::string("Prune ") + (m_pruneDeadEnds ? "ON" : "OFF");
+            m_status = m_pruneDeadEnds ? "Dead-end pruning: ON" : "Dead-end pruning: OFF";
+        };
+
+    by += (engineH + gap);
+
+    // --- Epsilon / deadline row (Weighted A* and ARA*) ---
+    float knobH = bh * 0.80f;
+    float knobW = (bw - gap) / 2.0f;
+
+    float knobLeftEdge = bx - bw * 0.5f;
+    float kx1 = knobLeftEdge + knobW * 0.5f;
+    float kx2 = kx1 + knobW + gap;
+
+    float yKnobs = by;
+
+    auto fmt1 = [](float v)
+        {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(1) << v;
+            return oss.str();
+        };
+
+    Button* epsBtn = addBtnAt(kx1, yKnobs, knobW, knobH, "Eps " + fmt1(m_epsilon), "orange", []() {});
+    epsBtn->textSize = 16.0f;
+    epsBtn->padX = 10.0f;
+    epsBtn->onClick = [this, epsBtn, fmt1]()
+        {
+            static const float levels[4] = { 1.5f, 2.0f, 3.0f, 5.0f };
+            int i = 0;
+            while (i < 4 && levels[i] <= m_epsilon) i++;
+            m_epsilon = levels[i % 4];
+
+            epsBtn->text = "Eps " + fmt1(m_epsilon);
+            m_status = "Epsilon " + fmt1(m_epsilon) + " (Weighted A* / ARA* start)";
+        };
+
+    Button* deadlineBtn = addBtnAt(kx2, yKnobs, knobW, knobH, "Deadline " + fmt1(m_deadlineMs) + "ms", "orange", []() {});
+    deadlineBtn->textSize = 16.0f;
+    deadlineBtn->padX = 10.0f;
+    deadlineBtn->onClick = [this, deadlineBtn, fmt1]()
+        {
+            static const float levels[4] = { 1.0f, 5.0f, 20.0f, 100.0f };
+            int i = 0;
+            while (i < 4 && levels[i] <= m_deadlineMs) i++;
+            m_deadlineMs = levels[i % 4];
+
+            deadlineBtn->text = "Deadline " + fmt1(m_deadlineMs) + "ms";
+            m_status = "ARA* deadline " + fmt1(m_deadlineMs) + " ms (instant search)";
+        };
+
+    by += (knobH + gap);
+
+    // --- Agent size row (clearance map) ---
+    Button* sizeBtn = addBtnAt(bx, by, bw, knobH, "Agent 1x1", "orange", []() {});
+    sizeBtn->textSize = 16.0f;
+    sizeBtn->onClick = [this, sizeBtn]()
+        {
+            cycleAgentSize();
+            sizeBtn->text = "Agent " + std::to_string(m_agentSize) + "x" + std::to_string(m_agentSize);
+        };
+
+    by += (knobH + gap);
+
     // --- Guide Panel ---
     const float panelMargin = 6.0f;
     const float panelTop = by + 2.0f;
@@ -36,6 +36,53 @@ void Grid::init(int rows, int cols, float startX, float startY, float cellSize)
             if (Node* right = getNode(r, c + 1)) n->neighbors.push_back(right);
         }
     }
+
+    rebuildWallTable();
+}
+
+void Grid::rebuildWallTable()
+{
+    const int w = m_cols + 1;
+    m_wallSum.assign((m_rows + 1) * w, 0);
+    for (int r = 0; r < m_rows; r++)
+    {
+        int rowWalls = 0;
+        for (int c = 0; c < m_cols; c++)
+        {
+            rowWalls += m_nodes[r * m_cols + c]->walkable ? 0 : 1;
+            m_wallSum[(r + 1) * w + c + 1] = m_wallSum[r * w + c + 1] + rowWalls;
+        }
+    }
+}
+
+void Grid::onWallToggled(int r, int c)
+{
+    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
+
+    const int delta = (m_nodes[r * m_cols + c]->walkable ? 0 : 1) - wallCount(r, c, r, c);
+    if (delta == 0) return;
+
+    // Every prefix that contains the cell: one contiguous run per row
+    const int w = m_cols + 1;
+    for (int rr = r + 1; rr <= m_rows; rr++)
+    {
+        int* row = &m_wallSum[rr * w];
+        for (int cc = c + 1; cc <= m_cols; cc++)
+            row[cc] += delta;
+    }
+}
+
+int Grid::wallCount(int r0, int c0, int r1, int c1) const
+{
+    if (r0 > r1) std::swap(r0, r1);
+    if (c0 > c1) std::swap(c0, c1);
+    r0 = std::max(r0, 0); c0 = std::max(c0, 0);
+    r1 = std::min(r1, m_rows - 1); c1 = std::min(c1, m_cols - 1);
+    if (r0 > r1 || c0 > c1) return 0;
+
+    const int w = m_cols + 1;
+    return m_wallSum[(r1 + 1) * w + c1 + 1] - m_wallSum[r0 * w + c1 + 1]
+         - m_wallSum[(r1 + 1) * w + c0] + m_wallSum[r0 * w + c0];
 }
 
 Node* Grid::getNode(int r, int c) const
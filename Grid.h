@@ -8,16 +8,33 @@ class Grid {
     int m_cols = 0;
     std::vector<Node*> m_nodes;
 
+    // Summed-area table of walls: entry (r + 1, c + 1) counts the walls in rows
+    // 0..r and columns 0..c, so any rectangle costs four reads
+    std::vector<int> m_wallSum;
+
 public:
     ~Grid();
 
     void init(int rows, int cols, float startX, float startY, float cellSize);
     void draw() const;
 
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
     Node* getNode(int r, int c) const;
     Node* getNodeFromPoint(float mx, float my) const;
     void resetVisuals();
     void clearAll();
 
     const std::vector<Node*>& getAllNodes() const { return m_nodes; }
+
+    // --- Wall counts per rectangle in O(1) ---
+    // Call after Node::walkable changed: rebuildWallTable() after bulk edits, or
+    // onWallToggled() for one cell (adds +-1 below and right of it).
+    void rebuildWallTable();
+    void onWallToggled(int r, int c);
+
+    // Rows r0..r1, columns c0..c1 inclusive, in either order, clamped to the grid
+    int wallCount(int r0, int c0, int r1, int c1) const;
+    bool anyWall(int r0, int c0, int r1, int c1) const { return wallCount(r0, c0, r1, c1) > 0; }
 };
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "GridSnapshot.h"
+#include <utility>
+
+// --- Pins ---
+
+int GridPins::pin(uint64_t epoch)
+{
+    for (int i = 0; i < SLOTS; i++)
+    {
+        uint64_t expected = 0;
+        if (m_slots[i].epoch.load(std::memory_order_relaxed) == 0 &&
+            m_slots[i].epoch.compare_exchange_strong(expected, epoch))
+            return i;
+    }
+    m_overflow.fetch_add(1);
+    return -1;
+}
+
+void GridPins::unpin(int slot)
+{
+    // Release: the snapshot's reads happen before the store may free what it read
+    if (slot < 0) m_overflow.fetch_sub(1, std::memory_order_release);
+    else m_slots[slot].epoch.store(0, std::memory_order_release);
+}
+
+uint64_t GridPins::oldest() const
+{
+    if (m_overflow.load(std::memory_order_acquire) > 0) return 0;
+    uint64_t oldest = UINT64_MAX;
+    for (const Slot& s : m_slots)
+    {
+        const uint64_t e = s.epoch.load(std::memory_order_acquire);
+        if (e != 0 && e < oldest) oldest = e;
+    }
+    return oldest;
+}
+
+// --- Snapshot handle ---
+
+GridSnapshot::GridSnapshot(const GridTable* table, GridPins* pins, uint64_t epoch)
+    : rows(table->rows), cols(table->cols), m_table(table), m_chunks(table->chunks.data()),
+      m_pins(pins), m_epoch(epoch), m_slot(pins->pin(epoch))
+{
+}
+
+GridSnapshot::GridSnapshot(const GridSnapshot& o)
+    : rows(o.rows), cols(o.cols), m_table(o.m_table), m_chunks(o.m_chunks),
+      m_pins(o.m_pins), m_epoch(o.m_epoch)
+{
+    // The original still pins this epoch, so nothing it sees can be freed meanwhile
+    if (m_pins) m_slot = m_pins->pin(m_epoch);
+}
+
+GridSnapshot::GridSnapshot(GridSnapshot&& o) noexcept
+    : rows(o.rows), cols(o.cols), m_table(o.m_table), m_chunks(o.m_chunks),
+      m_pins(o.m_pins), m_epoch(o.m_epoch), m_slot(o.m_slot)
+{
+    o.m_table = nullptr;
+    o.m_chunks = nullptr;
+    o.m_pins = nullptr;
+    o.rows = o.cols = 0;
+}
+
+GridSnapshot& GridSnapshot::operator=(GridSnapshot o) noexcept
+{
+    release();
+    std::swap(rows, o.rows);
+    std::swap(cols, o.cols);
+    std::swap(m_table, o.m_table);
+    std::swap(m_chunks, o.m_chunks);
+    std::swap(m_pins, o.m_pins);
+    std::swap(m_epoch, o.m_epoch);
+    std::swap(m_slot, o.m_slot);
+    return *this;
+}
+
+GridSnapshot::~GridSnapshot()
+{
+    release();
+}
+
+void GridSnapshot::release()
+{
+    if (m_pins) m_pins->unpin(m_slot);
+    m_table = nullptr;
+    m_chunks = nullptr;
+    m_pins = nullptr;
+    m_slot = -1;
+    rows = cols = 0;
+}
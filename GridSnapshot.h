@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "Node.h"
+
+// Chunked grid planes shared between a GridStore (the UI thread's editable
+// copy) and any number of GridSnapshots. A chunk is a run of 4096 row-major
+// cells. Nothing in it points back to Node objects.
+struct GridChunk
+{
+    static constexpr int SHIFT = 12;
+    static constexpr int SIZE = 1 << SHIFT;
+    static constexpr int MASK = SIZE - 1;
+
+    uint64_t epoch = 0;          // store epoch it was written in: older chunks may be shared with snapshots
+    uint8_t walkable[SIZE];      // 1 = walkable
+    uint8_t state[SIZE];         // level content as NodeVizState: Empty, Wall, Start or Goal
+};
+
+struct GridTable
+{
+    uint64_t epoch = 0;
+    int rows = 0;
+    int cols = 0;
+    std::vector<GridChunk*> chunks;
+};
+
+// Epochs pinned by live snapshots (epoch-based reclamation). The store frees a
+// chunk it replaced at epoch e only once every pinned epoch is >= e: snapshots
+// pinned earlier may still read it, later ones never saw it. Pinning and
+// unpinning are single atomic operations and may happen on any thread.
+class GridPins
+{
+public:
+    static constexpr int SLOTS = 64;
+
+    int pin(uint64_t epoch);   // slot index, -1 when every slot is taken (then nothing is freed until it is released)
+    void unpin(int slot);
+    uint64_t oldest() const;   // oldest pinned epoch, UINT64_MAX when none (0 while any overflow pin is held)
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> epoch{ 0 };   // 0: free
+    };
+
+    Slot m_slots[SLOTS];
+    std::atomic<int> m_overflow{ 0 };
+};
+
+// Immutable view of the grid's wall and state planes at the moment it was taken
+// (GridStore::snapshot, O(1)). Any number of threads can read it while the live
+// Grid keeps being edited: edits copy the chunks they touch, and the old ones
+// stay alive until every snapshot that may see them is gone. Copies pin the
+// same epoch, so a snapshot can be handed to a worker by value.
+struct GridSnapshot
+{
+    int rows = 0;
+    int cols = 0;
+
+    GridSnapshot() = default;
+    GridSnapshot(const GridSnapshot& o);
+    GridSnapshot(GridSnapshot&& o) noexcept;
+    GridSnapshot& operator=(GridSnapshot o) noexcept;
+    ~GridSnapshot();
+
+    bool empty() const { return m_table == nullptr; }
+    int cellCount() const { return rows * cols; }
+
+    bool walkableAt(int cell) const
+    {
+        return m_chunks[cell >> GridChunk::SHIFT]->walkable[cell & GridChunk::MASK] != 0;
+    }
+    bool isWalkable(int r, int c) const
+    {
+        return r >= 0 && r < rows && c >= 0 && c < cols && walkableAt(r * cols + c);
+    }
+    NodeVizState stateAt(int cell) const
+    {
+        return (NodeVizState)m_chunks[cell >> GridChunk::SHIFT]->state[cell & GridChunk::MASK];
+    }
+
+private:
+    friend class GridStore;
+    GridSnapshot(const GridTable* table, GridPins* pins, uint64_t epoch);
+    void release();
+
+    const GridTable* m_table = nullptr;
+    GridChunk* const* m_chunks = nullptr;   // m_table->chunks.data()
+    GridPins* m_pins = nullptr;
+    uint64_t m_epoch = 0;
+    int m_slot = -1;
+};
@@ -0,0 +1,199 @@
+#include "GridStore.h"
+#include <algorithm>
+#include <cstring>
+
+static uint8_t plainState(bool walkable)
+{
+    return (uint8_t)(walkable ? NodeVizState::Empty : NodeVizState::Wall);
+}
+
+GridStore::~GridStore()
+{
+    freeAll();
+}
+
+void GridStore::reset(const Grid& grid)
+{
+    // Everything goes: the old table and every chunk it holds
+    if (m_table)
+    {
+        for (GridChunk* c : m_table->chunks)
+            m_retiredChunks.push_back({ m_epoch, c });
+        m_retiredTables.push_back({ m_epoch, m_table });
+    }
+
+    const int rows = grid.rows();
+    const int cols = grid.cols();
+    const int n = rows * cols;
+    const std::vector<Node*>& nodes = grid.getAllNodes();
+
+    m_table = new GridTable();
+    m_table->epoch = m_epoch;
+    m_table->rows = rows;
+    m_table->cols = cols;
+    m_table->chunks.resize((n + GridChunk::MASK) >> GridChunk::SHIFT);
+    for (size_t k = 0; k < m_table->chunks.size(); k++)
+    {
+        GridChunk* c = new GridChunk();
+        c->epoch = m_epoch;
+        std::memset(c->walkable, 0, sizeof(c->walkable));
+        std::memset(c->state, 0, sizeof(c->state));
+
+        const int begin = (int)k << GridChunk::SHIFT;
+        const int end = std::min(n, begin + GridChunk::SIZE);
+        for (int i = begin; i < end; i++)
+        {
+            c->walkable[i - begin] = nodes[i]->walkable ? 1 : 0;
+            c->state[i - begin] = plainState(nodes[i]->walkable);
+        }
+        m_table->chunks[k] = c;
+    }
+    m_markers.clear();
+    m_copied = 0;
+    reclaim();
+}
+
+void GridStore::syncFrom(const Grid& grid)
+{
+    if (!m_table || m_table->rows != grid.rows() || m_table->cols != grid.cols())
+    {
+        reset(grid);
+        return;
+    }
+
+    // Compare in place; writeCell copies a chunk only at its first real change
+    const std::vector<Node*>& nodes = grid.getAllNodes();
+    const int n = m_table->rows * m_table->cols;
+    for (int cell = 0; cell < n; cell++)
+    {
+        const GridChunk* c = m_table->chunks[cell >> GridChunk::SHIFT];
+        if ((c->walkable[cell & GridChunk::MASK] != 0) != nodes[cell]->walkable)
+            setWalkable(cell, nodes[cell]->walkable);
+    }
+    reclaim();
+}
+
+void GridStore::setWalkable(int cell, bool walkable)
+{
+    if (!m_table || cell < 0 || cell >= m_table->rows * m_table->cols) return;
+
+    // Start/Goal marks survive a toggle back to floor
+    const uint8_t old = m_table->chunks[cell >> GridChunk::SHIFT]->state[cell & GridChunk::MASK];
+    const bool marked = old == (uint8_t)NodeVizState::Start || old == (uint8_t)NodeVizState::Goal;
+    writeCell(cell, walkable ? 1 : 0, (walkable && marked) ? old : plainState(walkable));
+}
+
+void GridStore::setMarkers(int startCell, const std::vector<int>& goalCells)
+{
+    if (!m_table) return;
+
+    std::vector<int> markers;
+    if (startCell >= 0) markers.push_back(startCell);
+    markers.insert(markers.end(), goalCells.begin(), goalCells.end());
+    if (markers == m_markers) return;
+
+    const int n = m_table->rows * m_table->cols;
+    for (int cell : m_markers)
+    {
+        if (cell < 0 || cell >= n) continue;
+        const uint8_t w = m_table->chunks[cell >> GridChunk::SHIFT]->walkable[cell & GridChunk::MASK];
+        writeCell(cell, w, plainState(w != 0));
+    }
+    for (size_t i = 0; i < markers.size(); i++)
+    {
+        const int cell = markers[i];
+        if (cell < 0 || cell >= n) continue;
+        const uint8_t w = m_table->chunks[cell >> GridChunk::SHIFT]->walkable[cell & GridChunk::MASK];
+        const NodeVizState s = (startCell >= 0 && i == 0) ? NodeVizState::Start : NodeVizState::Goal;
+        writeCell(cell, w, (uint8_t)s);
+    }
+    m_markers.swap(markers);
+    reclaim();
+}
+
+GridSnapshot GridStore::snapshot()
+{
+    if (!m_table) return GridSnapshot();
+
+    GridSnapshot snap(m_table, &m_pins, m_epoch);
+    m_epoch++;   // from here on, whatever this snapshot sees is copied before it is written
+    m_copied = 0;
+    reclaim();
+    return snap;
+}
+
+GridTable* GridStore::writableTable()
+{
+    if (m_table->epoch < m_epoch)
+    {
+        // Only the pointer array is copied; the chunks stay shared
+        GridTable* copy = new GridTable(*m_table);
+        copy->epoch = m_epoch;
+        m_retiredTables.push_back({ m_epoch, m_table });
+        m_table = copy;
+    }
+    return m_table;
+}
+
+GridChunk* GridStore::writableChunk(int chunk)
+{
+    GridTable* table = writableTable();
+    GridChunk* c = table->chunks[chunk];
+    if (c->epoch < m_epoch)
+    {
+        GridChunk* copy = new GridChunk(*c);
+        copy->epoch = m_epoch;
+        m_retiredChunks.push_back({ m_epoch, c });
+        table->chunks[chunk] = copy;
+        m_copied++;
+        c = copy;
+    }
+    return c;
+}
+
+void GridStore::writeCell(int cell, uint8_t walkable, uint8_t state)
+{
+    const int k = cell >> GridChunk::SHIFT;
+    const int i = cell & GridChunk::MASK;
+    const GridChunk* c = m_table->chunks[k];
+    if (c->walkable[i] == walkable && c->state[i] == state) return;
+
+    GridChunk* w = writableChunk(k);
+    w->walkable[i] = walkable;
+    w->state[i] = state;
+}
+
+void GridStore::reclaim()
+{
+    if (m_retiredChunks.empty() && m_retiredTables.empty()) return;
+
+    // Retired at epoch e: only snapshots pinned before e can still see it
+    const uint64_t oldest = m_pins.oldest();
+    auto sweep = [oldest](auto& list)
+        {
+            size_t kept = 0;
+            for (auto& r : list)
+            {
+                if (r.epoch <= oldest) delete r.ptr;
+                else list[kept++] = r;
+            }
+            list.resize(kept);
+        };
+    sweep(m_retiredChunks);
+    sweep(m_retiredTables);
+}
+
+void GridStore::freeAll()
+{
+    if (m_table)
+    {
+        for (GridChunk* c : m_table->chunks)
+            delete c;
+        delete m_table;
+        m_table = nullptr;
+    }
+    for (const Retired<GridChunk>& r : m_retiredChunks) delete r.ptr;
+    for (const Retired<GridTable>& r : m_retiredTables) delete r.ptr;
+    m_retiredChunks.clear();
+    m_retiredTables.clear();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Grid.h"
+#include "GridSnapshot.h"
+
+// The UI thread's copy of the grid's wall and state planes, in 4096-cell
+// chunks that snapshots share (copy-on-write).
+//
+// snapshot() pins the current epoch and starts a new one; that is all, O(1).
+// A chunk (or the chunk table) written in an older epoch may be shared, so the
+// first edit to it afterwards writes a fresh copy and retires the old one. The
+// retired ones are freed once no live snapshot pins an epoch before their
+// retirement. Only the UI thread calls into the store; snapshots may be read,
+// copied and dropped on any thread, but must not outlive the store.
+class GridStore
+{
+public:
+    GridStore() = default;
+    ~GridStore();
+
+    GridStore(const GridStore&) = delete;
+    GridStore& operator=(const GridStore&) = delete;
+
+    void reset(const Grid& grid);       // new level or size: every chunk is fresh
+    void syncFrom(const Grid& grid);    // after a bulk edit: only chunks that differ are copied
+    void setWalkable(int cell, bool walkable);
+    void setMarkers(int startCell, const std::vector<int>& goalCells);   // Start/Goal on the state plane
+
+    GridSnapshot snapshot();
+
+    bool empty() const { return m_table == nullptr; }
+    uint64_t epoch() const { return m_epoch; }
+    int chunkCount() const { return m_table ? (int)m_table->chunks.size() : 0; }
+    int copiedSinceSnapshot() const { return m_copied; }   // chunks written fresh since the last snapshot()
+    size_t retiredCount() const { return m_retiredChunks.size() + m_retiredTables.size(); }
+
+private:
+    template <typename T>
+    struct Retired
+    {
+        uint64_t epoch;
+        T* ptr;
+    };
+
+    GridTable* writableTable();
+    GridChunk* writableChunk(int chunk);
+    void writeCell(int cell, uint8_t walkable, uint8_t state);
+    void reclaim();
+    void freeAll();
+
+    GridTable* m_table = nullptr;
+    uint64_t m_epoch = 1;   // 0 means "free" in a pin slot
+    int m_copied = 0;
+    std::vector<int> m_markers;   // cells currently marked Start/Goal on the state plane
+
+    std::vector<Retired<GridChunk>> m_retiredChunks;
+    std::vector<Retired<GridTable>> m_retiredTables;
+    GridPins m_pins;
+};
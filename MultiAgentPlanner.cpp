@@ -0,0 +1,382 @@
+#include "MultiAgentPlanner.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <unordered_set>
+
+// --- ReservationTable ---
+
+void ReservationTable::reset(int cellCount)
+{
+    m_cells = cellCount;
+    m_words = (cellCount + 63) / 64;
+    m_steps.clear();
+    m_moves.clear();
+    m_parkedFrom.assign(cellCount, INT_MAX);
+    m_lastUse.assign(cellCount, -1);
+}
+
+uint64_t ReservationTable::moveKey(int from, int to, int t) const
+{
+    // Undirected edge at time t: a swap uses the same edge in the opposite direction
+    const int lo = std::min(from, to);
+    const int hi = std::max(from, to);
+    return ((uint64_t)t * m_cells + lo) * 2 + (hi - lo == 1 ? 0 : 1);
+}
+
+void ReservationTable::reservePath(const std::vector<int>& path)
+{
+    for (int t = 0; t < (int)path.size(); t++)
+    {
+        if ((int)m_steps.size() <= t)
+            m_steps.resize(t + 1, std::vector<uint64_t>(m_words, 0));
+
+        const int cell = path[t];
+        m_steps[t][cell >> 6] |= (uint64_t)1 << (cell & 63);
+        m_lastUse[cell] = std::max(m_lastUse[cell], t);
+
+        if (t > 0 && path[t - 1] != cell)
+            m_moves.insert(moveKey(path[t - 1], cell, t - 1));
+    }
+
+    if (!path.empty())
+        m_parkedFrom[path.back()] = std::min(m_parkedFrom[path.back()], (int)path.size() - 1);
+}
+
+bool ReservationTable::vertexFree(int cell, int t) const
+{
+    if (t >= m_parkedFrom[cell]) return false;
+    if (t < (int)m_steps.size() && (m_steps[t][cell >> 6] >> (cell & 63) & 1)) return false;
+    return true;
+}
+
+bool ReservationTable::moveFree(int from, int to, int t) const
+{
+    return m_moves.find(moveKey(from, to, t)) == m_moves.end();
+}
+
+// --- MultiAgentPlanner ---
+
+static const int DR[4] = { -1, 1, 0, 0 };
+static const int DC[4] = { 0, 0, -1, 1 };
+
+void MultiAgentPlanner::TrueDistance::init(const GridSnapshot& grid, int goalCell, int startCell)
+{
+    g.assign(grid.cellCount(), INT_MAX);
+    closed.assign(grid.cellCount(), 0);
+    for (std::vector<int>& b : buckets) b.clear();
+    goal = goalCell;
+    target = startCell;
+
+    if (goal < 0 || !grid.walkableAt(goal)) return;
+    g[goal] = 0;
+    curF = std::abs(goal / grid.cols - target / grid.cols) + std::abs(goal % grid.cols - target % grid.cols);
+    if ((int)buckets.size() <= curF) buckets.resize(curF + 1);
+    buckets[curF].push_back(goal);
+}
+
+int MultiAgentPlanner::TrueDistance::at(const GridSnapshot& grid, int cell)
+{
+    if (closed[cell]) return g[cell];
+
+    // Resume the reverse search until the queried cell is expanded. The
+    // Manhattan heuristic towards the start is consistent, so f only grows
+    // (a bucket queue is enough) and g is exact once a cell is closed.
+    const int cols = grid.cols;
+    auto manhattan = [&](int c) { return std::abs(c / cols - target / cols) + std::abs(c % cols - target % cols); };
+
+    while (curF < (int)buckets.size())
+    {
+        std::vector<int>& bucket = buckets[curF];
+        if (bucket.empty()) { curF++; continue; }
+
+        const int u = bucket.back();
+        bucket.pop_back();
+        if (closed[u]) continue;   // a cheaper copy was expanded already
+        closed[u] = 1;
+
+        for (int d = 0; d < 4; d++)
+        {
+            const int nr = u / cols + DR[d];
+            const int nc = u % cols + DC[d];
+            if (!grid.isWalkable(nr, nc)) continue;
+
+            const int v = nr * cols + nc;
+            if (closed[v] || g[u] + 1 >= g[v]) continue;
+            g[v] = g[u] + 1;
+
+            const int f = g[v] + manhattan(v);
+            if ((int)buckets.size() <= f) buckets.resize(f + 1);
+            buckets[f].push_back(v);
+        }
+
+        if (u == cell) return g[u];
+    }
+    return INT_MAX;
+}
+
+bool MultiAgentPlanner::planAgent(int agent, const ReservationTable* table,
+    const std::vector<Constraint>* cons, std::vector<int>& path)
+{
+    path.clear();
+
+    const Agent& a = m_agents[agent];
+    TrueDistance& h = m_goalDist[agent];
+    if (a.start < 0 || h.at(*m_grid, a.start) == INT_MAX) return false;
+
+    const int cells = m_grid->cellCount();
+    const int cols = m_grid->cols;
+
+    // This agent's CBS constraints, hashed by (t, cell) and (t, from, dir)
+    std::unordered_set<uint64_t> vertexCons, moveCons;
+    int goalBlockedUntil = table ? table->lastUse(a.goal) : -1;
+    int latestCons = 0;
+    if (cons)
+    {
+        for (const Constraint& c : *cons)
+        {
+            if (c.agent != agent) continue;
+            latestCons = std::max(latestCons, c.t + 1);
+            if (c.from < 0)
+            {
+                vertexCons.insert((uint64_t)c.t * cells + c.cell);
+                if (c.cell == a.goal) goalBlockedUntil = std::max(goalBlockedUntil, c.t);
+            }
+            else
+            {
+                moveCons.insert(((uint64_t)c.t * cells + c.from) * (uint64_t)cells + c.cell);
+            }
+        }
+    }
+
+    // Enough time to wait out every reservation and still walk to the goal
+    const int maxT = h.at(*m_grid, a.start) + (table ? table->horizon() : 0) + latestCons + m_grid->rows + m_grid->cols;
+
+    struct StNode { int cell, t, parent; };
+    struct OpenEntry
+    {
+        int f, g, node;
+        bool operator>(const OpenEntry& o) const
+        {
+            if (f != o.f) return f > o.f;
+            return g < o.g;   // deeper first on ties
+        }
+    };
+
+    // The goal cannot be held before goalBlockedUntil + 1, which bounds the arrival time too
+    auto heuristic = [&](int cell, int t) { return std::max(h.at(*m_grid, cell), goalBlockedUntil + 1 - t); };
+
+    std::vector<StNode> nodes;
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+    std::unordered_set<uint64_t> seen;
+
+    nodes.push_back({ a.start, 0, -1 });
+    open.push({ heuristic(a.start, 0), 0, 0 });
+    seen.insert((uint64_t)a.start);
+
+    while (!open.empty())
+    {
+        const OpenEntry e = open.top();
+        open.pop();
+        const StNode cur = nodes[e.node];
+        m_expanded++;
+
+        if (cur.cell == a.goal && cur.t > goalBlockedUntil)
+        {
+            for (int i = e.node; i != -1; i = nodes[i].parent)
+                path.push_back(nodes[i].cell);
+            std::reverse(path.begin(), path.end());
+            return true;
+        }
+
+        const int t1 = cur.t + 1;
+        if (t1 > maxT) continue;
+
+        const int r = cur.cell / cols;
+        const int c = cur.cell % cols;
+        for (int d = -1; d < 4; d++)   // -1 = wait
+        {
+            int v = cur.cell;
+            if (d >= 0)
+            {
+                if (!m_grid->isWalkable(r + DR[d], c + DC[d])) continue;
+                v = (r + DR[d]) * cols + (c + DC[d]);
+            }
+            if (h.at(*m_grid, v) == INT_MAX) continue;
+
+            const uint64_t key = (uint64_t)t1 * cells + v;
+            if (seen.count(key)) continue;
+
+            if (table && !table->vertexFree(v, t1)) continue;
+            if (table && v != cur.cell && !table->moveFree(cur.cell, v, cur.t)) continue;
+            if (vertexCons.count(key)) continue;
+            if (v != cur.cell && moveCons.count(((uint64_t)cur.t * cells + cur.cell) * (uint64_t)cells + v)) continue;
+
+            seen.insert(key);
+            nodes.push_back({ v, t1, e.node });
+            open.push({ t1 + heuristic(v, t1), t1, (int)nodes.size() - 1 });
+        }
+    }
+    return false;
+}
+
+bool MultiAgentPlanner::runCooperative()
+{
+    ReservationTable table;
+    table.reset(m_grid->cellCount());
+
+    bool all = true;
+    for (int i = 0; i < (int)m_agents.size(); i++)
+    {
+        if (planAgent(i, &table, nullptr, m_paths[i]))
+            table.reservePath(m_paths[i]);
+        else
+            all = false;
+    }
+    return all;
+}
+
+bool MultiAgentPlanner::findConflict(const std::vector<std::vector<int>>& paths, Conflict& out) const
+{
+    int horizon = 0;
+    for (const std::vector<int>& p : paths)
+        horizon = std::max(horizon, (int)p.size());
+
+    // Finished agents keep standing on their last cell
+    auto at = [&](int i, int t) { return paths[i][std::min(t, (int)paths[i].size() - 1)]; };
+
+    const int k = (int)paths.size();
+    for (int t = 0; t < horizon; t++)
+    {
+        for (int i = 0; i < k; i++)
+        {
+            for (int j = i + 1; j < k; j++)
+            {
+                if (at(i, t) == at(j, t))
+                {
+                    out = { i, j, at(i, t), -1, t };
+                    return true;
+                }
+                if (t + 1 < horizon && at(i, t) == at(j, t + 1) && at(i, t + 1) == at(j, t) && at(i, t) != at(i, t + 1))
+                {
+                    out = { i, j, at(i, t + 1), at(i, t), t };
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool MultiAgentPlanner::runCbs()
+{
+    struct CtNode
+    {
+        std::vector<Constraint> cons;
+        std::vector<std::vector<int>> paths;
+        int cost = 0;
+    };
+    auto costOf = [](const std::vector<std::vector<int>>& paths)
+        {
+            int c = 0;
+            for (const std::vector<int>& p : paths) c += (int)p.size() - 1;
+            return c;
+        };
+
+    std::vector<CtNode> tree(1);
+    tree[0].paths.resize(m_agents.size());
+    for (int i = 0; i < (int)m_agents.size(); i++)
+        if (!planAgent(i, nullptr, &tree[0].cons, tree[0].paths[i])) return false;
+    tree[0].cost = costOf(tree[0].paths);
+
+    using Entry = std::pair<int, int>;   // (cost, node)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    open.push({ tree[0].cost, 0 });
+
+    const int nodeBudget = 2000;
+    while (!open.empty() && m_cbsNodes < nodeBudget)
+    {
+        const int id = open.top().second;
+        open.pop();
+        m_cbsNodes++;
+
+        Conflict cf;
+        if (!findConflict(tree[id].paths, cf))
+        {
+            m_paths = tree[id].paths;
+            return true;
+        }
+
+        // Branch: forbid the conflict for one agent or the other
+        for (int side = 0; side < 2; side++)
+        {
+            Constraint c;
+            c.agent = side == 0 ? cf.a : cf.b;
+            c.t = cf.t;
+            if (cf.from < 0)
+            {
+                c.cell = cf.cell;
+                c.from = -1;
+                c.t = cf.t;
+            }
+            else
+            {
+                // a moved from -> cell, b moved cell -> from
+                c.from = side == 0 ? cf.from : cf.cell;
+                c.cell = side == 0 ? cf.cell : cf.from;
+            }
+
+            CtNode child;
+            child.cons = tree[id].cons;
+            child.cons.push_back(c);
+            child.paths = tree[id].paths;
+            if (!planAgent(c.agent, nullptr, &child.cons, child.paths[c.agent])) continue;
+
+            child.cost = costOf(child.paths);
+            tree.push_back(std::move(child));
+            open.push({ tree.back().cost, (int)tree.size() - 1 });
+        }
+    }
+    return false;
+}
+
+bool MultiAgentPlanner::plan(const GridSnapshot& grid, const std::vector<Agent>& agents, Method method, int cbsMaxAgents)
+{
+    m_grid = &grid;
+    m_agents = agents;
+    m_paths.assign(agents.size(), {});
+    m_expanded = 0;
+    m_cbsNodes = 0;
+
+    m_goalDist.resize(agents.size());
+    for (int i = 0; i < (int)agents.size(); i++)
+        m_goalDist[i].init(grid, agents[i].goal, agents[i].start);
+
+    if (method == Method::CBS && (int)agents.size() <= cbsMaxAgents)
+    {
+        m_used = Method::CBS;
+        if (runCbs()) return true;
+        m_paths.assign(agents.size(), {});   // budget ran out: cooperative fallback
+    }
+
+    m_used = Method::Cooperative;
+    return runCooperative();
+}
+
+int MultiAgentPlanner::sumOfCosts() const
+{
+    int c = 0;
+    for (const std::vector<int>& p : m_paths)
+        if (!p.empty()) c += (int)p.size() - 1;
+    return c;
+}
+
+int MultiAgentPlanner::makespan() const
+{
+    int m = 0;
+    for (const std::vector<int>& p : m_paths)
+        if (!p.empty()) m = std::max(m, (int)p.size() - 1);
+    return m;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <unordered_set>
+#include "GridSnapshot.h"
+
+// Space-time reservations for cooperative planning. Vertex occupancy is one
+// bitset per timestep (cells/64 words); moves are kept in a hash set so swaps
+// can be rejected. A finished agent stays parked on its goal forever.
+class ReservationTable
+{
+public:
+    void reset(int cellCount);
+
+    // path[t] is the agent's cell at time t; the last cell is held from then on
+    void reservePath(const std::vector<int>& path);
+
+    bool vertexFree(int cell, int t) const;
+    bool moveFree(int from, int to, int t) const;   // from at t -> to at t+1
+    int lastUse(int cell) const { return m_lastUse[cell]; }
+    int horizon() const { return (int)m_steps.size(); }
+
+private:
+    static int moveDir(int from, int to);
+    uint64_t moveKey(int from, int to, int t) const;
+
+    int m_cells = 0;
+    int m_words = 0;
+    std::vector<std::vector<uint64_t>> m_steps;   // bitset per timestep
+    std::unordered_set<uint64_t> m_moves;         // (t, from, direction)
+    std::vector<int> m_parkedFrom;                // time a finished agent takes the cell for good
+    std::vector<int> m_lastUse;                   // latest timestep the cell is reserved (-1: never)
+};
+
+// Conflict-free routes for several Start/Goal pairs on one grid.
+//
+// Cooperative A* plans agents one after another through a ReservationTable,
+// using the true distance to the goal as heuristic, computed lazily by a
+// reverse resumable A* from the goal (only the cells a query touches). For a handful of
+// agents, Conflict-Based Search finds routes with the lowest total cost and
+// falls back to cooperative planning if its node budget runs out.
+class MultiAgentPlanner
+{
+public:
+    struct Agent
+    {
+        int start = -1;   // cell index (row * cols + col)
+        int goal = -1;
+    };
+
+    enum class Method { Cooperative, CBS };
+
+    // Returns true if every agent got a route. CBS is only tried for up to
+    // cbsMaxAgents agents.
+    bool plan(const GridSnapshot& grid, const std::vector<Agent>& agents, Method method, int cbsMaxAgents = 8);
+
+    // Per agent: cell at every timestep (t = index); empty if the agent failed
+    const std::vector<std::vector<int>>& paths() const { return m_paths; }
+
+    Method usedMethod() const { return m_used; }
+    int sumOfCosts() const;
+    int makespan() const;
+    int expandedCount() const { return m_expanded; }
+    int cbsNodes() const { return m_cbsNodes; }
+
+private:
+    struct Constraint
+    {
+        int agent;
+        int cell;      // vertex: cell at time t; move: destination cell
+        int from;      // -1 for vertex constraints
+        int t;
+    };
+
+    struct Conflict
+    {
+        int a = -1, b = -1;
+        int cell = -1, from = -1, t = -1;   // vertex conflict, or swap on (from -> cell) for a
+    };
+
+    // Reverse resumable A* from one agent's goal towards its start
+    struct TrueDistance
+    {
+        std::vector<int> g;
+        std::vector<char> closed;
+        std::vector<std::vector<int>> buckets;   // open cells by f (f never decreases)
+        int curF = 0;
+        int goal = -1;
+        int target = -1;
+
+        void init(const GridSnapshot& grid, int goalCell, int startCell);
+        int at(const GridSnapshot& grid, int cell);   // INT_MAX if unreachable
+    };
+
+    bool planAgent(int agent, const ReservationTable* table, const std::vector<Constraint>* cons,
+        std::vector<int>& path);
+    bool runCooperative();
+    bool runCbs();
+    bool findConflict(const std::vector<std::vector<int>>& paths, Conflict& out) const;
+
+    const GridSnapshot* m_grid = nullptr;
+    std::vector<Agent> m_agents;
+    std::vector<TrueDistance> m_goalDist;   // heuristic per agent
+    std::vector<std::vector<int>> m_paths;
+    Method m_used = Method::Cooperative;
+    int m_expanded = 0;
+    int m_cbsNodes = 0;
+};
@@ -0,0 +1,152 @@
+#include "NearOptimalRoutes.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+int NearOptimalRoutes::build(const GridSnapshot& grid, int startCell, const std::vector<int>& distGoal, int unreachable,
+    const Options& opt)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    m_routes.clear();
+    m_lastExpansions = 0;
+    m_lastSearches = 0;
+
+    const int n = grid.cellCount();
+    if (startCell >= 0 && startCell < n && (int)distGoal.size() == n && distGoal[startCell] < unreachable)
+    {
+        if ((int)m_seen.size() != n)
+        {
+            m_g.assign(n, 0);
+            m_moves.assign(n, 0);
+            m_parent.assign(n, -1);
+            m_seen.assign(n, 0);
+            m_closed.assign(n, 0);
+            m_stamp = 0;
+        }
+        m_cost.assign(n, 0);
+
+        int penalty = std::max(1, opt.penalty);
+        const int shortest = distGoal[startCell];
+        const int maxMoves = shortest + (int)(shortest * std::max(0.0f, opt.maxStretch));
+
+        while ((int)m_routes.size() < opt.k && m_lastSearches < opt.maxSearches)
+        {
+            m_lastSearches++;
+            Path route = search(grid, startCell, distGoal, maxMoves, opt.maxExpansions);
+            if (route.empty()) break;   // everything left within the bound is too expensive
+
+            bool duplicate = false;
+            for (const Path& kept : m_routes)
+            {
+                if (route.overlap(kept) > opt.maxShared * route.cellCount())
+                {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (!duplicate) m_routes.push_back(route);
+            else penalty *= 2;   // the last push was too weak to leave the shared cells
+
+            // Push the next search away from this route, kept or not
+            for (int cell : route.cells())
+                m_cost[cell] += penalty;
+        }
+    }
+
+    m_lastMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    return (int)m_routes.size();
+}
+
+Path NearOptimalRoutes::search(const GridSnapshot& grid, int startCell, const std::vector<int>& distGoal, int maxMoves,
+    int maxExpansions)
+{
+    if (++m_stamp == 0)
+    {
+        std::fill(m_seen.begin(), m_seen.end(), 0);
+        std::fill(m_closed.begin(), m_closed.end(), 0);
+        m_stamp = 1;
+    }
+    m_heap.clear();
+
+    std::greater<OpenEntry> cmp;
+    const int cols = grid.cols;
+    m_g[startCell] = 0;
+    m_moves[startCell] = 0;
+    m_parent[startCell] = -1;
+    m_seen[startCell] = m_stamp;
+    m_heap.push_back({ distGoal[startCell], distGoal[startCell], startCell });
+
+    static const int DR[4] = { -1, 1, 0, 0 };
+    static const int DC[4] = { 0, 0, -1, 1 };
+
+    int expanded = 0;
+    while (!m_heap.empty() && expanded < maxExpansions)
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), cmp);
+        const OpenEntry top = m_heap.back();
+        m_heap.pop_back();
+
+        const int u = top.cell;
+        if (m_closed[u] == m_stamp || top.f != m_g[u] + top.h) continue;   // stale entry
+        m_closed[u] = m_stamp;
+        expanded++;
+
+        if (distGoal[u] == 0)
+        {
+            m_lastExpansions += expanded;
+            std::vector<int> cells;
+            for (int v = u; v != -1; v = m_parent[v])
+                cells.push_back(v);
+            std::reverse(cells.begin(), cells.end());
+            return Path(std::move(cells), cols);
+        }
+
+        const int r = u / cols;
+        const int c = u % cols;
+        for (int d = 0; d < 4; d++)
+        {
+            const int nr = r + DR[d];
+            const int nc = c + DC[d];
+            if (!grid.isWalkable(nr, nc)) continue;
+
+            const int v = nr * cols + nc;
+            const int moves = m_moves[u] + 1;
+            if (m_closed[v] == m_stamp || moves + distGoal[v] > maxMoves) continue;
+
+            const int g = m_g[u] + 1 + m_cost[v];
+            if (m_seen[v] == m_stamp && g >= m_g[v]) continue;
+
+            m_seen[v] = m_stamp;
+            m_g[v] = g;
+            m_moves[v] = moves;
+            m_parent[v] = u;
+            m_heap.push_back({ g + distGoal[v], distGoal[v], v });
+            std::push_heap(m_heap.begin(), m_heap.end(), cmp);
+        }
+    }
+
+    m_lastExpansions += expanded;
+    return Path();
+}
+
+int NearOptimalRoutes::bestMatch(const Path& path, float minMatch, float* match) const
+{
+    int best = -1;
+    float bestMatch = 0.0f;
+    for (int i = 0; i < (int)m_routes.size(); i++)
+    {
+        const Path& route = m_routes[i];
+        const int longer = std::max(path.cellCount(), route.cellCount());
+        if (longer == 0) continue;
+
+        const float m = (float)path.overlap(route) / (float)longer;
+        if (m >= minMatch && m > bestMatch)
+        {
+            best = i;
+            bestMatch = m;
+        }
+    }
+
+    if (match) *match = bestMatch;
+    return best;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "GridSnapshot.h"
+#include "Path.h"
+
+// Up to k distinct Start->Goal routes that are all "almost optimal", for scoring.
+//
+// Penalty method: the first route is a shortest path; after each route the
+// cells on it cost more to enter, and the next A* search finds the cheapest
+// route under the raised costs. Every step still costs at least 1, so the exact
+// goal distance field (GlobalState::distGoal) stays an admissible heuristic and
+// each search only widens around the previous routes instead of flooding the
+// grid. Cells that cannot lie on a route within the length bound
+// (moves so far + goal distance > bound) are never opened.
+//
+// Yen's k shortest simple paths would be exact, but on a 4-connected grid its
+// top k are nearly always equal-length copies that differ by one corner; the
+// penalty routes are the genuinely different alternatives a player might take.
+class NearOptimalRoutes
+{
+public:
+    struct Options
+    {
+        int k = 4;                    // routes wanted, the shortest one included
+        float maxStretch = 0.25f;     // routes at most this much longer than the shortest
+        float maxShared = 0.8f;       // a route sharing more of its cells with a kept one is a duplicate
+        int penalty = 1;              // extra entry cost for a route's cells; doubles after each duplicate
+        int maxSearches = 12;         // searches per build, kept routes or not
+        int maxExpansions = 200000;   // per search
+    };
+
+    // distGoal: exact distance to the nearest goal (0 on goal cells, >= unreachable
+    // if cut off). Returns the number of routes found; 0 if Start cannot reach a goal.
+    int build(const GridSnapshot& grid, int startCell, const std::vector<int>& distGoal, int unreachable,
+        const Options& opt);
+    void clear() { m_routes.clear(); }
+
+    const std::vector<Path>& routes() const { return m_routes; }
+
+    // Index of the route the path follows most closely, if at least minMatch of
+    // the cells of the longer of the two are shared; -1 otherwise. match gets the fraction.
+    int bestMatch(const Path& path, float minMatch, float* match = nullptr) const;
+
+    double lastMicros() const { return m_lastMicros; }
+    int lastExpansions() const { return m_lastExpansions; }
+    int lastSearches() const { return m_lastSearches; }
+
+private:
+    struct OpenEntry
+    {
+        int f, h, cell;
+        bool operator>(const OpenEntry& o) const
+        {
+            if (f != o.f) return f > o.f;
+            return h > o.h;
+        }
+    };
+
+    // Cheapest route under the current penalties, empty if none within maxMoves
+    Path search(const GridSnapshot& grid, int startCell, const std::vector<int>& distGoal, int maxMoves,
+        int maxExpansions);
+
+    std::vector<Path> m_routes;
+
+    // Search scratch, reset in O(1) per search through a stamp
+    std::vector<int> m_cost;      // penalty per cell
+    std::vector<int> m_g;
+    std::vector<int> m_moves;
+    std::vector<int> m_parent;
+    std::vector<uint32_t> m_seen;
+    std::vector<uint32_t> m_closed;
+    std::vector<OpenEntry> m_heap;
+    uint32_t m_stamp = 0;
+
+    double m_lastMicros = 0.0;
+    int m_lastExpansions = 0;
+    int m_lastSearches = 0;
+};
@@ -0,0 +1,221 @@
+#include "ParallelAStar.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+
+static uint64_t splitMix(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+bool ParallelAStar::receive(Worker& w, const Message& m)
+{
+    if (m.g >= m_g[m.cell]) return false;
+    m_g[m.cell] = m.g;
+    m_parent[m.cell] = m.parent;
+    m_closed[m.cell] = 0;   // reopened if it was expanded with a worse g
+
+    // The goal is never expanded: reaching it only tightens the bound
+    if (m.cell == m_goal)
+    {
+        if (m.g < m_best.load(std::memory_order_relaxed))
+            m_best.store(m.g, std::memory_order_relaxed);
+        return false;
+    }
+
+    const int h = std::abs(m.cell / m_cols - m_goalRow) + std::abs(m.cell % m_cols - m_goalCol);
+    w.heap.push_back({ m.g + h, h, m.g, m.cell });
+    std::push_heap(w.heap.begin(), w.heap.end(), std::greater<OpenEntry>());
+    return true;
+}
+
+void ParallelAStar::send(int id, Worker& w, const Message& m)
+{
+    m_busy.fetch_add(1);   // before it can be seen, so the count never dips to zero early
+    w.messages++;
+
+    const int to = owner(m.cell);
+    std::vector<Message>& pending = w.outbox[to];
+    if (!pending.empty() || !ring(id, to).push(m))
+        pending.push_back(m);   // keep the order per destination
+}
+
+void ParallelAStar::flush(int id, Worker& w)
+{
+    for (int to = 0; to < m_threads; to++)
+    {
+        std::vector<Message>& pending = w.outbox[to];
+        size_t sent = 0;
+        while (sent < pending.size() && ring(id, to).push(pending[sent]))
+            sent++;
+        pending.erase(pending.begin(), pending.begin() + sent);
+    }
+}
+
+bool ParallelAStar::hasWork(Worker& w)
+{
+    std::greater<OpenEntry> cmp;
+    const int best = m_best.load(std::memory_order_relaxed);
+    while (!w.heap.empty())
+    {
+        const OpenEntry& top = w.heap.front();
+        if (!m_closed[top.cell] && top.g == m_g[top.cell] && top.f < best) return true;
+
+        // Expanded, superseded, or cannot beat the goal path found so far
+        std::pop_heap(w.heap.begin(), w.heap.end(), cmp);
+        w.heap.pop_back();
+    }
+    return false;
+}
+
+void ParallelAStar::work(int id)
+{
+    static const int DR[4] = { -1, 1, 0, 0 };
+    static const int DC[4] = { 0, 0, -1, 1 };
+    const int batch = 64;   // expansions between two looks at the inboxes
+
+    Worker& w = m_workers[id];
+    std::greater<OpenEntry> cmp;
+
+    while (true)
+    {
+        // --- Incoming cells ---
+        for (int from = 0; from < m_threads; from++)
+        {
+            if (from == id) continue;
+            Message m;
+            while (ring(from, id).pop(m))
+            {
+                receive(w, m);
+                if (!w.active && hasWork(w)) w.active = true;   // the message's unit becomes ours
+                else m_busy.fetch_sub(1);
+            }
+        }
+        flush(id, w);
+
+        // --- Expansion ---
+        if (hasWork(w))
+        {
+            for (int k = 0; k < batch && hasWork(w); k++)
+            {
+                std::pop_heap(w.heap.begin(), w.heap.end(), cmp);
+                const OpenEntry e = w.heap.back();
+                w.heap.pop_back();
+
+                const int u = e.cell;
+                m_closed[u] = 1;
+                w.expanded++;
+
+                const int r = u / m_cols;
+                const int c = u % m_cols;
+                for (int d = 0; d < 4; d++)
+                {
+                    const int nr = r + DR[d];
+                    const int nc = c + DC[d];
+                    if (!m_grid->isWalkable(nr, nc)) continue;
+
+                    const int v = nr * m_cols + nc;
+                    const int gv = e.g + 1;
+                    const int h = std::abs(nr - m_goalRow) + std::abs(nc - m_goalCol);
+                    if (gv + h >= m_best.load(std::memory_order_relaxed)) continue;
+
+                    const Message m{ v, gv, u };
+                    if (owner(v) == id) receive(w, m);
+                    else send(id, w, m);
+                }
+            }
+            continue;
+        }
+
+        // --- Idle: give up our unit, stop once nobody holds one ---
+        if (w.active)
+        {
+            w.active = false;
+            m_busy.fetch_sub(1);
+        }
+        if (m_busy.load() == 0) return;
+        std::this_thread::yield();
+    }
+}
+
+ParallelAStar::Result ParallelAStar::run(const GridSnapshot& grid, int startCell, int goalCell, int threads, uint64_t seed)
+{
+    Result result;
+    const int n = grid.cellCount();
+    if (startCell < 0 || startCell >= n || goalCell < 0 || goalCell >= n) return result;
+    if (!grid.walkableAt(startCell) || !grid.walkableAt(goalCell)) return result;
+
+    if (threads <= 0)
+        threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    m_threads = std::max(1, std::min(threads, 64));
+    result.threads = m_threads;
+
+    m_grid = &grid;
+    m_cols = grid.cols;
+    m_goal = goalCell;
+    m_goalRow = goalCell / m_cols;
+    m_goalCol = goalCell % m_cols;
+
+    // --- Zobrist ownership: one random key per block row and per block column ---
+    const int blockRows = (grid.rows + BLOCK - 1) / BLOCK;
+    m_blockCols = (grid.cols + BLOCK - 1) / BLOCK;
+    std::vector<uint64_t> rowKey(blockRows), colKey(m_blockCols);
+    for (uint64_t& k : rowKey) k = splitMix(seed);
+    for (uint64_t& k : colKey) k = splitMix(seed);
+    m_blockOwner.resize((size_t)blockRows * m_blockCols);
+    for (int br = 0; br < blockRows; br++)
+        for (int bc = 0; bc < m_blockCols; bc++)
+            m_blockOwner[br * m_blockCols + bc] = (uint8_t)((rowKey[br] ^ colKey[bc]) % (uint64_t)m_threads);
+
+    // --- Shared state, rings and workers ---
+    m_g.assign(n, INT_MAX);
+    m_parent.assign(n, -1);
+    m_closed.assign(n, 0);
+
+    m_rings.clear();
+    for (int i = 0; i < m_threads * m_threads; i++)
+        m_rings.emplace_back(new SpscRing<Message>(4096));
+
+    m_workers.assign(m_threads, Worker());
+    for (Worker& w : m_workers)
+        w.outbox.resize(m_threads);
+
+    m_best.store(startCell == goalCell ? 0 : INT_MAX);
+    m_busy.store(1);
+    Worker& first = m_workers[owner(startCell)];
+    receive(first, Message{ startCell, 0, -1 });
+    first.active = true;
+
+    // --- Search ---
+    std::vector<std::thread> pool;
+    pool.reserve(m_threads - 1);
+    for (int id = 1; id < m_threads; id++)
+        pool.emplace_back(&ParallelAStar::work, this, id);
+    work(0);   // the calling thread works too
+
+    for (std::thread& t : pool)
+        t.join();
+
+    for (const Worker& w : m_workers)
+    {
+        result.expanded += w.expanded;
+        result.messages += w.messages;
+    }
+
+    const int best = m_best.load();
+    if (best == INT_MAX) return result;
+
+    result.found = true;
+    result.length = best;
+    std::vector<int> cells;
+    for (int v = goalCell; v != -1 && (int)cells.size() <= best; v = m_parent[v])
+        cells.push_back(v);
+    std::reverse(cells.begin(), cells.end());
+    result.path = Path(std::move(cells), m_cols);
+    return result;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include "GridSnapshot.h"
+#include "SpscRing.h"
+#include "Path.h"
+
+// One Start/Goal query spread over several threads (HDA*, Kishimoto et al.).
+//
+// Every cell has an owner thread, picked by a Zobrist hash of the 16x16 block it
+// lies in (whole blocks keep most neighbours on the same thread, so most
+// generated cells never leave it). Only the owner opens, expands or writes the
+// g/parent entry of a cell; a neighbour owned elsewhere is sent to its owner
+// through a lock-free SPSC ring per thread pair. Workers never wait on each
+// other: a full ring just keeps the message in a local outbox.
+//
+// The first goal reached is only an upper bound; workers keep expanding cells
+// with f below it until nothing useful is left anywhere. Termination counts
+// outstanding work in one atomic: +1 per message in flight, +1 per worker with
+// cells left to expand. A worker hands a message's unit over to itself when the
+// message wakes it up, so the count can only reach zero once, when everything
+// is done.
+class ParallelAStar
+{
+public:
+    static constexpr int BLOCK = 16;   // cells per side of a hashed block
+
+    struct Result
+    {
+        bool found = false;
+        int length = -1;        // steps, -1 if unreachable
+        int expanded = 0;       // all threads, re-expansions included
+        int messages = 0;       // cells sent to another thread
+        int threads = 0;
+        Path path;
+    };
+
+    // threads <= 0 uses every hardware thread
+    Result run(const GridSnapshot& grid, int startCell, int goalCell, int threads = 0, uint64_t seed = 0x9E3779B97F4A7C15ull);
+
+private:
+    struct Message
+    {
+        int cell;
+        int g;
+        int parent;
+    };
+
+    struct OpenEntry
+    {
+        int f, h, g, cell;
+        bool operator>(const OpenEntry& o) const
+        {
+            if (f != o.f) return f > o.f;
+            return h > o.h;
+        }
+    };
+
+    struct Worker
+    {
+        std::vector<OpenEntry> heap;
+        std::vector<std::vector<Message>> outbox;   // per destination, waiting for ring space
+        bool active = false;
+        int expanded = 0;
+        int messages = 0;
+    };
+
+    int owner(int cell) const { return m_blockOwner[(cell / m_cols / BLOCK) * m_blockCols + (cell % m_cols) / BLOCK]; }
+    SpscRing<Message>& ring(int from, int to) { return *m_rings[from * m_threads + to]; }
+
+    void work(int id);
+    bool receive(Worker& w, const Message& m);          // true if the cell got a better g
+    void send(int id, Worker& w, const Message& m);
+    void flush(int id, Worker& w);
+    bool hasWork(Worker& w);                           // drops stale and bounded-out entries off the top
+
+    const GridSnapshot* m_grid = nullptr;
+    int m_cols = 0;
+    int m_goal = -1;
+    int m_goalRow = 0;
+    int m_goalCol = 0;
+    int m_threads = 1;
+
+    int m_blockCols = 0;
+    std::vector<uint8_t> m_blockOwner;   // per 16x16 block: the thread that owns its cells
+
+    // Shared by index, but each entry is only ever touched by its owner
+    std::vector<int> m_g;
+    std::vector<int> m_parent;
+    std::vector<char> m_closed;
+
+    std::vector<Worker> m_workers;
+    std::vector<std::unique_ptr<SpscRing<Message>>> m_rings;   // [from * threads + to]
+
+    std::atomic<int> m_best{ 0 };        // cost of the best goal path so far
+    std::atomic<long long> m_busy{ 0 };  // messages in flight + workers with work
+};
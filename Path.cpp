@@ -0,0 +1,165 @@
+#include "Path.h"
+#include "Node.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Direction codes shared with FringeSearch: up, down, left, right
+static const int DR[4] = { -1, 1, 0, 0 };
+static const int DC[4] = { 0, 0, -1, 1 };
+
+static constexpr int MAX_RUN = 64;
+
+Path Path::fromNodes(const std::vector<Node*>& nodes, int cols)
+{
+    std::vector<int> cells;
+    cells.reserve(nodes.size());
+    for (const Node* n : nodes)
+        if (n) cells.push_back(n->row * cols + n->col);
+    return Path(std::move(cells), cols);
+}
+
+Path Path::lShape(int from, int to, int cols)
+{
+    int r = from / cols, c = from % cols;
+    const int tr = to / cols, tc = to % cols;
+
+    std::vector<int> cells;
+    cells.reserve(std::abs(tr - r) + std::abs(tc - c) + 1);
+    cells.push_back(from);
+    while (c != tc) { c += (tc > c) ? 1 : -1; cells.push_back(r * cols + c); }
+    while (r != tr) { r += (tr > r) ? 1 : -1; cells.push_back(r * cols + c); }
+    return Path(std::move(cells), cols);
+}
+
+int Path::direction(int from, int to) const
+{
+    const int dr = to / m_cols - from / m_cols;
+    if (dr < 0) return 0;
+    if (dr > 0) return 1;
+    return (to < from) ? 2 : 3;
+}
+
+int Path::turns() const
+{
+    int turns = 0;
+    for (size_t i = 2; i < m_cells.size(); i++)
+    {
+        // Same step twice in a row means no turn
+        if (m_cells[i] - m_cells[i - 1] != m_cells[i - 1] - m_cells[i - 2]) turns++;
+    }
+    return turns;
+}
+
+int Path::overlap(const std::vector<char>& mask) const
+{
+    int hits = 0;
+    for (int cell : m_cells)
+        if (cell >= 0 && cell < (int)mask.size() && mask[cell]) hits++;
+    return hits;
+}
+
+int Path::overlap(const Path& other) const
+{
+    std::vector<int> a = m_cells;
+    std::vector<int> b = other.m_cells;
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    a.erase(std::unique(a.begin(), a.end()), a.end());
+    b.erase(std::unique(b.begin(), b.end()), b.end());
+
+    int shared = 0;
+    for (size_t i = 0, j = 0; i < a.size() && j < b.size(); )
+    {
+        if (a[i] < b[j]) i++;
+        else if (b[j] < a[i]) j++;
+        else { shared++; i++; j++; }
+    }
+    return shared;
+}
+
+Path::Encoded Path::encode() const
+{
+    Encoded e;
+    e.cols = m_cols;
+    if (m_cells.empty()) return e;
+
+    e.start = m_cells.front();
+    e.moves = length();
+
+    std::vector<uint8_t> runs;
+    for (size_t i = 1; i < m_cells.size(); )
+    {
+        const int dir = direction(m_cells[i - 1], m_cells[i]);
+        int run = 1;
+        while (i + run < m_cells.size() && run < MAX_RUN &&
+            direction(m_cells[i + run - 1], m_cells[i + run]) == dir)
+            run++;
+
+        runs.push_back((uint8_t)(dir | ((run - 1) << 2)));
+        i += run;
+    }
+
+    const size_t packedBytes = ((size_t)e.moves + 3) / 4;
+    if (runs.size() < packedBytes)
+    {
+        e.runLength = true;
+        e.data = std::move(runs);
+        e.data.shrink_to_fit();
+        return e;
+    }
+
+    e.data.assign(packedBytes, 0);
+    for (int i = 0; i < e.moves; i++)
+        e.data[i / 4] |= (uint8_t)(direction(m_cells[i], m_cells[i + 1]) << (2 * (i % 4)));
+    return e;
+}
+
+int Path::Encoded::turns() const
+{
+    int turns = 0;
+    if (runLength)
+    {
+        for (size_t i = 1; i < data.size(); i++)
+            if ((data[i] & 3) != (data[i - 1] & 3)) turns++;
+        return turns;
+    }
+
+    for (int i = 1; i < moves; i++)
+    {
+        const int prev = (data[(i - 1) / 4] >> (2 * ((i - 1) % 4))) & 3;
+        const int dir = (data[i / 4] >> (2 * (i % 4))) & 3;
+        if (dir != prev) turns++;
+    }
+    return turns;
+}
+
+Path Path::decode(const Encoded& e)
+{
+    std::vector<int> cells;
+    if (e.start < 0) return Path(cells, e.cols);
+
+    cells.reserve(e.moves + 1);
+    cells.push_back(e.start);
+
+    int r = e.start / e.cols;
+    int c = e.start % e.cols;
+    auto move = [&](int dir)
+        {
+            r += DR[dir];
+            c += DC[dir];
+            cells.push_back(r * e.cols + c);
+        };
+
+    if (e.runLength)
+    {
+        for (uint8_t run : e.data)
+            for (int k = (run >> 2) + 1; k > 0; k--)
+                move(run & 3);
+    }
+    else
+    {
+        for (int i = 0; i < e.moves; i++)
+            move((e.data[i / 4] >> (2 * (i % 4))) & 3);
+    }
+    return Path(std::move(cells), e.cols);
+}
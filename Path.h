@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class Node;
+
+// A 4-connected route as row-major cell indices, Start first, in one contiguous
+// buffer. Every search engine hands its result over as one (the background
+// worker once it has sent Found, Theta* as the cells its segments cross), and
+// scoring, rendering and caches read it without going back to Node::parent
+// links or the grid.
+//
+// encode() keeps the moves as 2-bit directions, four to a byte, so any path
+// costs a quarter byte per move. Corridor-like paths are run-length encoded
+// instead when that is smaller: one byte per straight run (direction in the low
+// 2 bits, run length - 1 in the upper 6; runs longer than 64 take several
+// bytes). PathService keeps its finished answers in this form.
+class Path
+{
+public:
+    struct Encoded
+    {
+        int start = -1;
+        int cols = 0;
+        int moves = 0;
+        bool runLength = false;      // data holds runs, otherwise packed moves
+        std::vector<uint8_t> data;
+
+        size_t memoryBytes() const { return sizeof(Encoded) + data.capacity(); }
+        int turns() const;
+    };
+
+    Path() = default;
+    Path(std::vector<int> cells, int cols) : m_cells(std::move(cells)), m_cols(cols) {}
+    static Path fromNodes(const std::vector<Node*>& nodes, int cols);
+
+    // Along the row first, then along the column. A shortest path whenever the
+    // bounding box of the two cells has no walls (see Grid::anyWall).
+    static Path lShape(int from, int to, int cols);
+
+    bool empty() const { return m_cells.empty(); }
+    int cellCount() const { return (int)m_cells.size(); }
+    int length() const { return m_cells.empty() ? 0 : (int)m_cells.size() - 1; }   // moves
+    int front() const { return m_cells.front(); }
+    int back() const { return m_cells.back(); }
+    int cols() const { return m_cols; }
+    const std::vector<int>& cells() const { return m_cells; }
+    void clear() { m_cells.clear(); }
+
+    int turns() const;                                   // direction changes along the path
+    int overlap(const std::vector<char>& mask) const;    // cells with mask[cell] != 0
+    int overlap(const Path& other) const;                // distinct cells both paths visit
+
+    size_t memoryBytes() const { return sizeof(Path) + m_cells.capacity() * sizeof(int); }
+
+    // Every step must move to a 4-neighbour
+    Encoded encode() const;
+    static Path decode(const Encoded& e);
+
+private:
+    int direction(int from, int to) const;
+
+    std::vector<int> m_cells;
+    int m_cols = 0;
+};
@@ -0,0 +1,295 @@
+#include "PathService.h"
+#include <algorithm>
+#include <chrono>
+
+void PathService::reset(Grid& grid)
+{
+    clear();
+    m_grid = &grid;
+}
+
+void PathService::clear()
+{
+    m_jobs.clear();
+    m_freeJobs.clear();
+    m_tickets.clear();
+    m_freeTickets.clear();
+    m_queue.clear();
+    m_byPair.clear();
+    m_freePool.clear();
+    for (int i = 0; i < (int)m_pool.size(); i++)
+        m_freePool.push_back(i);
+
+    m_completed = 0;
+    m_coalesced = 0;
+    m_restarts = 0;
+    m_lastFrameUs = 0.0;
+    m_lastFrameExpansions = 0;
+}
+
+uint64_t PathService::pairKey(const Node* start, const Node* goal)
+{
+    const uint64_t a = ((uint64_t)(uint32_t)start->row << 16) | (uint32_t)start->col;
+    const uint64_t b = ((uint64_t)(uint32_t)goal->row << 16) | (uint32_t)goal->col;
+    return (a << 32) | b;
+}
+
+int PathService::ticketOf(Handle h) const
+{
+    if (h < 0) return -1;
+    const int slot = h & ((1 << SLOT_BITS) - 1);
+    if (slot >= (int)m_tickets.size()) return -1;
+    const Ticket& ticket = m_tickets[slot];
+    return (ticket.live && ticket.generation == (h >> SLOT_BITS)) ? slot : -1;
+}
+
+PathService::Handle PathService::newTicket(int job)
+{
+    int slot;
+    if (!m_freeTickets.empty())
+    {
+        slot = m_freeTickets.back();
+        m_freeTickets.pop_back();
+    }
+    else
+    {
+        slot = (int)m_tickets.size();
+        m_tickets.emplace_back();
+    }
+
+    Ticket& ticket = m_tickets[slot];
+    ticket.job = job;
+    ticket.live = true;
+    return (ticket.generation << SLOT_BITS) | slot;
+}
+
+int PathService::newJob()
+{
+    if (m_freeJobs.empty())
+    {
+        m_jobs.emplace_back();
+        return (int)m_jobs.size() - 1;
+    }
+    const int id = m_freeJobs.back();
+    m_freeJobs.pop_back();
+    return id;
+}
+
+void PathService::dropRef(int id)
+{
+    Job& job = m_jobs[id];
+    if (--job.refs > 0) return;
+
+    if (job.status == Status::Pending || job.status == Status::Running)
+        finish(id, Status::Cancelled);
+
+    // Nobody can ask for it any more: forget it as a shared answer and recycle it
+    if (job.start && job.goal)
+    {
+        auto it = m_byPair.find(pairKey(job.start, job.goal));
+        if (it != m_byPair.end() && it->second == id) m_byPair.erase(it);
+    }
+    job = Job();
+    m_freeJobs.push_back(id);
+}
+
+PathService::Handle PathService::submit(Node* start, Node* goal, int priority)
+{
+    if (m_grid && start && goal)
+    {
+        // Same question already asked: share its search (or its answer)
+        auto it = m_byPair.find(pairKey(start, goal));
+        if (it != m_byPair.end())
+        {
+            Job& job = m_jobs[it->second];
+            job.refs++;
+            job.priority = std::max(job.priority, priority);
+            m_coalesced++;
+            return newTicket(it->second);
+        }
+    }
+
+    const int id = newJob();
+    Job& job = m_jobs[id];
+    job.start = start;
+    job.goal = goal;
+    job.priority = priority;
+    job.order = m_order++;
+    job.refs = 1;
+
+    const Handle h = newTicket(id);
+    if (!m_grid || !start || !goal)
+    {
+        finish(id, Status::NoPath);
+        return h;
+    }
+
+    m_byPair[pairKey(start, goal)] = id;
+    m_queue.push_back(id);
+    return h;
+}
+
+void PathService::cancel(Handle h)
+{
+    const int slot = ticketOf(h);
+    if (slot < 0) return;
+
+    Ticket& ticket = m_tickets[slot];
+    const int job = ticket.job;
+    ticket.live = false;
+    ticket.job = -1;
+    ticket.generation = (ticket.generation + 1) & GENERATION_MASK;
+    m_freeTickets.push_back(slot);
+
+    dropRef(job);
+}
+
+PathService::Status PathService::status(Handle h) const
+{
+    const int slot = ticketOf(h);
+    if (slot < 0) return Status::Cancelled;
+    return m_jobs[m_tickets[slot].job].status;
+}
+
+bool PathService::done(Handle h) const
+{
+    const Status s = status(h);
+    return s == Status::Found || s == Status::NoPath || s == Status::Cancelled;
+}
+
+Path PathService::path(Handle h) const
+{
+    if (status(h) != Status::Found) return Path();
+    return Path::decode(m_jobs[m_tickets[ticketOf(h)].job].path);
+}
+
+size_t PathService::pathBytes() const
+{
+    size_t bytes = 0;
+    for (const Job& job : m_jobs)
+        if (job.status == Status::Found) bytes += job.path.memoryBytes();
+    return bytes;
+}
+
+Node* PathService::requestStart(Handle h) const
+{
+    const int slot = ticketOf(h);
+    return slot < 0 ? nullptr : m_jobs[m_tickets[slot].job].start;
+}
+
+Node* PathService::requestGoal(Handle h) const
+{
+    const int slot = ticketOf(h);
+    return slot < 0 ? nullptr : m_jobs[m_tickets[slot].job].goal;
+}
+
+int PathService::pickJob() const
+{
+    // The queue holds a handful of jobs; a scan is cheaper than keeping a heap
+    // in order while priorities get raised by coalesced requests
+    int best = -1;
+    for (int id : m_queue)
+    {
+        const Job& job = m_jobs[id];
+        if (best < 0 || job.priority > m_jobs[best].priority ||
+            (job.priority == m_jobs[best].priority && job.order < m_jobs[best].order))
+            best = id;
+    }
+    return best;
+}
+
+void PathService::releaseSearch(Job& job)
+{
+    if (job.pf < 0) return;
+    m_freePool.push_back(job.pf);
+    job.pf = -1;
+}
+
+void PathService::finish(int id, Status status)
+{
+    Job& job = m_jobs[id];
+    job.status = status;
+    releaseSearch(job);
+    m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), id), m_queue.end());
+
+    if (status == Status::Cancelled)
+    {
+        auto it = m_byPair.find(pairKey(job.start, job.goal));
+        if (it != m_byPair.end() && it->second == id) m_byPair.erase(it);
+        return;
+    }
+    m_completed++;
+}
+
+void PathService::runFrame(double budgetMicros)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+    auto elapsedUs = [&]() { return std::chrono::duration<double, std::micro>(Clock::now() - t0).count(); };
+
+    m_lastFrameExpansions = 0;
+
+    while (!m_queue.empty())
+    {
+        const int id = pickJob();
+        Job& job = m_jobs[id];
+
+        if (job.pf < 0)
+        {
+            if (m_freePool.empty())
+            {
+                m_pool.emplace_back();
+                m_freePool.push_back((int)m_pool.size() - 1);
+            }
+            job.pf = m_freePool.back();
+            m_freePool.pop_back();
+
+            Pathfinder& pf = m_pool[job.pf];
+            pf.setWritesNodes(false);
+            pf.setGridSize(m_grid->rows(), m_grid->cols());
+            pf.setMode(Pathfinder::Mode::Optimal, 1.0f);
+            pf.clearSearchMask();
+            pf.start(job.start, job.goal);
+            job.status = Status::Running;
+        }
+
+        Pathfinder& pf = m_pool[job.pf];
+        const Pathfinder::Progress p = pf.stepFor(SLICE, std::max(1.0, budgetMicros - elapsedUs()));
+        const Pathfinder::Result r = p.result;
+        m_lastFrameExpansions += p.expansions;
+
+        if (r == Pathfinder::Result::Found)
+        {
+            job.path = pf.path().encode();
+            finish(id, Status::Found);
+        }
+        else if (r == Pathfinder::Result::NoPath)
+        {
+            finish(id, Status::NoPath);
+        }
+
+        if (elapsedUs() >= budgetMicros) break;
+    }
+
+    m_lastFrameUs = elapsedUs();
+}
+
+void PathService::onWallsChanged()
+{
+    // Searches in flight may have expanded through the edited cell
+    for (int id : m_queue)
+    {
+        Job& job = m_jobs[id];
+        if (job.pf < 0) continue;
+        m_pool[job.pf].start(job.start, job.goal);
+        m_restarts++;
+    }
+
+    // Finished answers stay with their handles but are not handed out again
+    for (auto it = m_byPair.begin(); it != m_byPair.end(); )
+    {
+        const Status s = m_jobs[it->second].status;
+        if (s == Status::Found || s == Status::NoPath) it = m_byPair.erase(it);
+        else ++it;
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Grid.h"
+#include "Pathfinder.h"
+
+// Prioritized path requests served a slice at a time within a per-frame budget.
+//
+// Callers submit (start, goal, priority) and get a handle they poll. Every
+// request is an incremental Pathfinder search that never writes into Node, so
+// any number of them can be in flight on the live grid while the visual search
+// runs. runFrame() keeps stepping the highest-priority unfinished job (oldest
+// first within a priority) until the microsecond budget is spent; a new, more
+// urgent request preempts the current one at the next slice and the preempted
+// search resumes later where it stopped. Requests for the same (start, goal)
+// share one search, and a finished answer is handed out again until the walls
+// change. Answers are held as Path::Encoded (a quarter byte per move or less)
+// and only expanded to cells when someone asks for them.
+//
+// A handle is held until the caller cancels it, finished or not. Once no handle
+// refers to a job, the job (and its path) and the handle slots go back on free
+// lists; a handle carries its slot's generation, so an old one reads as
+// Cancelled instead of seeing the request that reused the slot.
+class PathService
+{
+public:
+    using Handle = int;
+    enum class Status { Pending, Running, Found, NoPath, Cancelled };
+
+    void reset(Grid& grid);   // binds the grid and drops every request
+    void clear();             // drops every request (Node pointers may be stale)
+
+    Handle submit(Node* start, Node* goal, int priority);
+    void cancel(Handle h);    // releases the handle; the search stops once no handle needs it any more
+
+    Status status(Handle h) const;
+    bool done(Handle h) const;
+    Path path(Handle h) const;          // Start..Goal once Found, else empty
+    Node* requestStart(Handle h) const;
+    Node* requestGoal(Handle h) const;
+
+    // Steps the queue until budgetMicros is used up or nothing is left to do
+    void runFrame(double budgetMicros);
+
+    // A wall was toggled: unfinished searches start over, old answers are not reused
+    void onWallsChanged();
+
+    int pendingCount() const { return (int)m_queue.size(); }
+    int completedCount() const { return m_completed; }
+    int coalescedCount() const { return m_coalesced; }
+    int restartCount() const { return m_restarts; }
+    int liveHandles() const { return (int)(m_tickets.size() - m_freeTickets.size()); }
+    int jobSlots() const { return (int)m_jobs.size(); }   // high-water mark of jobs held at once
+    size_t pathBytes() const;                             // held by the encoded answers
+    double lastFrameMicros() const { return m_lastFrameUs; }
+    int lastFrameExpansions() const { return m_lastFrameExpansions; }
+
+    static constexpr int SLICE = 32;   // expansions between preemption checks
+
+private:
+    struct Job
+    {
+        Node* start = nullptr;
+        Node* goal = nullptr;
+        int priority = 0;
+        uint64_t order = 0;   // submission order, FIFO within a priority
+        int refs = 0;
+        int pf = -1;          // index into m_pool while the search is running
+        Status status = Status::Pending;
+        Path::Encoded path;
+    };
+
+    struct Ticket
+    {
+        int job = -1;
+        int generation = 0;   // bumped when the slot is freed
+        bool live = false;
+    };
+
+    static constexpr int SLOT_BITS = 20;   // handle = generation << SLOT_BITS | slot
+    static constexpr int GENERATION_MASK = (1 << (31 - SLOT_BITS)) - 1;
+
+    static uint64_t pairKey(const Node* start, const Node* goal);
+    int ticketOf(Handle h) const;   // slot of a live handle, -1 for stale or invalid ones
+    Handle newTicket(int job);
+    int newJob();
+    void dropRef(int job);          // frees the job once no handle refers to it
+    int pickJob() const;
+    void finish(int job, Status status);
+    void releaseSearch(Job& job);
+
+    Grid* m_grid = nullptr;
+    std::vector<Job> m_jobs;
+    std::vector<int> m_freeJobs;
+    std::vector<Ticket> m_tickets;
+    std::vector<int> m_freeTickets;
+    std::vector<int> m_queue;                        // unfinished jobs
+    std::unordered_map<uint64_t, int> m_byPair;      // (start, goal) -> job to share
+
+    std::vector<Pathfinder> m_pool;                  // detached searches, reused
+    std::vector<int> m_freePool;
+    uint64_t m_order = 0;
+
+    int m_completed = 0;
+    int m_coalesced = 0;
+    int m_restarts = 0;
+    double m_lastFrameUs = 0.0;
+    int m_lastFrameExpansions = 0;
+};
@@ -1,5 +1,8 @@
 #include "Pathfinder.h"
+#include "Grid.h"
 #include <algorithm>
+#include <chrono>
+#include <climits>
 #include <cmath>
 
 float Pathfinder::heuristic(const Node* a, const Node* b) const
@@ -7,75 +10,405 @@ float Pathfinder::heuristic(const Node* a, const Node* b) const
     return float(std::abs(a->row - b->row) + std::abs(a->col - b->col));
 }
 
+float Pathfinder::heuristic(const Node* n) const
+{
+    if (m_exactH) return float((*m_exactH)[n->row * m_exactCols + n->col]);
+    if (m_multiGoal) return m_hScale * float(m_goalField[n->row * m_fieldCols + n->col]);
+    return m_hScale * heuristic(n, m_goal);
+}
+
+bool Pathfinder::isGoal(const Node* n) const
+{
+    if (m_multiGoal) return m_goalField[n->row * m_fieldCols + n->col] == 0;
+    return n == m_goal;
+}
+
+void Pathfinder::buildGoalField(const std::vector<Node*>& goals, int rows, int cols)
+{
+    if (goals == m_goalSet && (int)m_goalField.size() == rows * cols && m_fieldCols == cols)
+        return;   // same goal set as last time: keep the field
+
+    m_goalSet = goals;
+    m_fieldCols = cols;
+
+    // Two-pass L1 distance transform: exact min over goals of |dr| + |dc|
+    const int big = rows + cols;
+    m_goalField.assign(rows * cols, big);
+    for (const Node* g : goals)
+        if (g) m_goalField[g->row * cols + g->col] = 0;
+
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++)
+        {
+            int& d = m_goalField[r * cols + c];
+            if (r > 0) d = std::min(d, m_goalField[(r - 1) * cols + c] + 1);
+            if (c > 0) d = std::min(d, m_goalField[r * cols + c - 1] + 1);
+        }
+    for (int r = rows - 1; r >= 0; r--)
+        for (int c = cols - 1; c >= 0; c--)
+        {
+            int& d = m_goalField[r * cols + c];
+            if (r < rows - 1) d = std::min(d, m_goalField[(r + 1) * cols + c] + 1);
+            if (c < cols - 1) d = std::min(d, m_goalField[r * cols + c + 1] + 1);
+        }
+}
+
+void Pathfinder::setGridSize(int rows, int cols)
+{
+    if (cols == m_cols && (int)m_rec.size() == rows * cols) return;
+
+    m_cols = cols;
+    m_rec.assign(rows * cols, Record());
+    m_recStamp.assign(rows * cols, 0);
+    m_stamp = 0;
+}
+
+Pathfinder::Record& Pathfinder::rec(const Node* n)
+{
+    const int cell = cellOf(n);
+    if (m_recStamp[cell] != m_stamp)
+    {
+        m_recStamp[cell] = m_stamp;
+        m_rec[cell] = Record();
+    }
+    return m_rec[cell];
+}
+
+const Pathfinder::Record& Pathfinder::peek(const Node* n) const
+{
+    static const Record untouched;
+    const int cell = cellOf(n);
+    return (m_recStamp[cell] == m_stamp) ? m_rec[cell] : untouched;
+}
+
+void Pathfinder::sync(Node* n, const Record& r) const
+{
+    // The visualizer and the path walk in GlobalState read these
+    if (!m_writeNodes) return;
+    n->g = r.g;
+    n->h = r.h;
+    n->f = r.f;
+    n->parent = r.parent;
+}
+
+Path Pathfinder::path() const
+{
+    std::vector<int> cells;
+    if (m_goal && peek(m_goal).g < 1e9f)
+    {
+        for (const Node* n = m_goal; n; n = peek(n).parent)
+            cells.push_back(cellOf(n));
+        std::reverse(cells.begin(), cells.end());
+    }
+    return Path(std::move(cells), m_cols);
+}
+
+void Pathfinder::setMode(Mode mode, float epsilon)
+{
+    m_mode = mode;
+    m_epsStart = (mode == Mode::Optimal) ? 1.0f : std::max(1.0f, epsilon);
+}
+
 void Pathfinder::start(Node* start, Node* goal)
 {
+    m_multiGoal = false;
     m_open.clear();
+    m_incons.clear();
+    m_round = 1;
+    m_eps = m_epsStart;
     m_start = start;
     m_goal = goal;
+    m_expanded = 0;
+    m_peakOpen = 0;
+    m_peakIncons = 0;
+    m_emptyBox = false;
 
     if (!m_start || !m_goal) return;
 
-    m_start->g = 0.0f;
-    m_start->h = heuristic(m_start, m_goal);
-    m_start->f = m_start->g + m_start->h;
-    m_start->parent = nullptr;
+    // New stamp: every record reads as untouched again
+    if (++m_stamp == 0)
+    {
+        std::fill(m_recStamp.begin(), m_recStamp.end(), 0);
+        m_stamp = 1;
+    }
+
+    Record& r = rec(m_start);
+    r.g = 0.0f;
+    r.h = heuristic(m_start);
+    r.f = key(r);
+    r.parent = nullptr;
+    r.open = true;
+    sync(m_start, r);
 
     m_open.push_back(m_start);
+    m_peakOpen = 1;
+}
+
+void Pathfinder::start(Node* start, const std::vector<Node*>& goals, int rows, int cols)
+{
+    setGridSize(rows, cols);
+    if (goals.size() <= 1)
+    {
+        this->start(start, goals.empty() ? nullptr : goals.front());
+        return;
+    }
+
+    buildGoalField(goals, rows, cols);
+    this->start(start, goals.front());
+    m_multiGoal = true;
+
+    if (m_start)
+    {
+        Record& r = rec(m_start);
+        r.h = heuristic(m_start);
+        r.f = key(r);
+        sync(m_start, r);
+    }
 }
 
 Pathfinder::Result Pathfinder::step()
 {
     if (!m_start || !m_goal) return Result::NoPath;
-
-    if (m_open.empty())
-        return Result::NoPath;
+    if (m_emptyBox || (m_expanded == 0 && layEmptyBoxPath())) return Result::Found;
 
     auto itMin = std::min_element(m_open.begin(), m_open.end(),
-        [](const Node* a, const Node* b)
+        [this](const Node* a, const Node* b)
         {
-            if (a->f == b->f) return a->h < b->h;
-            return a->f < b->f;
+            const Record& ra = peek(a);
+            const Record& rb = peek(b);
+            if (ra.f == rb.f) return ra.h < rb.h;
+            return ra.f < rb.f;
         });
 
+    // ARA* ends a round once nothing in open can beat the goal's key
+    const float goalG = peek(m_goal).g;
+    if (m_mode == Mode::Anytime && goalG < 1e9f &&
+        (itMin == m_open.end() || goalG <= peek(*itMin).f))
+        return Result::Found;
+
+    if (m_open.empty())
+        return Result::NoPath;
+
     Node* current = *itMin;
     m_open.erase(itMin);
+    m_expanded++;
 
-    if (current != m_start && current != m_goal)
+    Record& cur = rec(current);
+    cur.open = false;
+    cur.closedRound = m_round;
+
+    if (m_writeNodes && current != m_start && !isGoal(current))
         current->state = NodeVizState::Closed;
 
-    if (current == m_goal)
+    if (isGoal(current) && m_mode != Mode::Anytime)
+    {
+        m_goal = current;
         return Result::Found;
+    }
+
+    if (m_graph)
+    {
+        // Contiguous arc scan; one-way arcs and teleporters are just arcs
+        const int u = cellOf(current);
+        for (int e = m_graph->firstArc(u); e < m_graph->lastArc(u); e++)
+            relax(current, (*m_graphNodes)[m_graph->target(e)], (float)m_graph->weight(e));
+    }
+    else
+    {
+        for (Node* nb : current->neighbors)
+            relax(current, nb, 1.0f);
+    }
+
+    return Result::Running;
+}
 
-    for (Node* nb : current->neighbors)
+bool Pathfinder::layEmptyBoxPath()
+{
+    if (!m_wallGrid || m_multiGoal || m_clearance || m_start == m_goal) return false;
+    if (m_wallGrid->anyWall(m_start->row, m_start->col, m_goal->row, m_goal->col)) return false;
+
+    // Nothing in the box can block the L, and it is as short as the Manhattan distance
+    const Path l = Path::lShape(cellOf(m_start), cellOf(m_goal), m_cols);
+    Node* prev = m_start;
+    for (int i = 1; i < l.cellCount(); i++)
     {
-        if (!nb->walkable) continue;
-        if (nb->state == NodeVizState::Closed) continue;
+        Node* n = m_wallGrid->getNode(l.cells()[i] / m_cols, l.cells()[i] % m_cols);
+        Record& r = rec(n);
+        r.g = (float)i;
+        r.h = 0.0f;
+        r.f = r.g;
+        r.parent = prev;
+        r.open = false;
+        sync(n, r);
+        prev = n;
+    }
 
-        float tentative_g = current->g + 1.0f;
+    m_open.clear();
+    m_emptyBox = true;
+    return true;
+}
 
-        bool inOpen = (std::find(m_open.begin(), m_open.end(), nb) != m_open.end());
-        if (!inOpen || tentative_g < nb->g)
-        {
-            nb->parent = current;
-            nb->g = tentative_g;
-            nb->h = heuristic(nb, m_goal);
-            nb->f = nb->g + nb->h;
+void Pathfinder::relax(Node* current, Node* nb, float cost)
+{
+    if (!nb->walkable) return;
+    if (m_mask && !(*m_mask)[nb->row * m_maskCols + nb->col]) return;
+    if (m_clearance && (*m_clearance)[nb->row * m_clearanceCols + nb->col] < m_agentSize) return;
+    if (m_exactH && (*m_exactH)[nb->row * m_exactCols + nb->col] >= m_exactUnreachable) return;
+
+    const bool closed = peek(nb).closedRound == m_round;
+    if (closed && m_mode != Mode::Anytime) return;
+
+    const float tentative_g = rec(current).g + cost;
+
+    // Records start at g = 1e9 every search, so "unseen" needs no special case
+    Record& r = rec(nb);
+    if (tentative_g < r.g)
+    {
+        r.parent = current;
+        r.g = tentative_g;
+        r.h = heuristic(nb);
+        r.f = key(r);
+        sync(nb, r);
+
+        // ARA* tracks the cheapest goal reached so far
+        if (m_multiGoal && isGoal(nb) && r.g < peek(m_goal).g)
+            m_goal = nb;
 
-            if (!inOpen)
+        if (closed)
+        {
+            // Closed this round: revisit in the next, tighter round
+            if (!r.incons)
             {
-                m_open.push_back(nb);
-                if (nb != m_start && nb != m_goal)
-                    nb->state = NodeVizState::Open;
+                r.incons = true;
+                m_incons.push_back(nb);
+                m_peakIncons = std::max(m_peakIncons, (int)m_incons.size());
             }
         }
+        else if (!r.open)
+        {
+            r.open = true;
+            m_open.push_back(nb);
+            m_peakOpen = std::max(m_peakOpen, (int)m_open.size());
+            if (m_writeNodes && nb != m_start && !isGoal(nb))
+                nb->state = NodeVizState::Open;
+        }
     }
+}
 
-    return Result::Running;
+Pathfinder::Progress Pathfinder::stepFor(int maxExpansions, double maxMicros)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+    auto elapsedUs = [&]() { return std::chrono::duration<double, std::micro>(Clock::now() - t0).count(); };
+
+    if (maxExpansions <= 0) maxExpansions = INT_MAX;
+    const int expandedBefore = m_expanded;
+
+    Progress p;
+    for (int i = 0; ; i++)
+    {
+        p.result = step();
+        if (p.result != Result::Running) break;
+        if (m_expanded - expandedBefore >= maxExpansions) break;
+
+        // Reading the clock costs about as much as a small expansion; do it every 16 steps
+        if (maxMicros > 0.0 && (i & 15) == 15 && elapsedUs() >= maxMicros) break;
+    }
+
+    p.expansions = m_expanded - expandedBefore;
+    p.elapsedUs = elapsedUs();
+    return p;
+}
+
+bool Pathfinder::canImprove() const
+{
+    return m_mode == Mode::Anytime && m_goal && peek(m_goal).g < 1e9f && suboptimalityBound() > 1.0f;
+}
+
+bool Pathfinder::improve(float epsStep)
+{
+    if (!canImprove()) return false;
+
+    m_eps = std::max(1.0f, m_eps - epsStep);
+
+    // Reuse the previous round: inconsistent nodes go back to open, keys are redone
+    for (Node* n : m_incons)
+    {
+        Record& r = rec(n);
+        r.incons = false;
+        if (!r.open)
+        {
+            r.open = true;
+            m_open.push_back(n);
+        }
+    }
+    m_incons.clear();
+    m_round++;   // nothing is closed in the new round
+
+    for (Node* n : m_open)
+    {
+        Record& r = rec(n);
+        r.f = key(r);
+        sync(n, r);
+    }
+
+    m_peakOpen = std::max(m_peakOpen, (int)m_open.size());
+    return true;
+}
+
+float Pathfinder::suboptimalityBound() const
+{
+    if (m_mode == Mode::Optimal) return 1.0f;
+    if (m_mode == Mode::Weighted) return m_eps;
+    const float goalG = m_goal ? peek(m_goal).g : 1e9f;
+    if (goalG >= 1e9f) return m_eps;
+
+    // g(goal) / lower bound on the optimal cost, taken over everything still unexpanded
+    float lower = goalG;
+    for (const Node* n : m_open)   lower = std::min(lower, peek(n).g + peek(n).h);
+    for (const Node* n : m_incons) lower = std::min(lower, peek(n).g + peek(n).h);
+
+    if (lower <= 0.0f) return m_eps;
+    return std::min(m_eps, goalG / lower);
+}
+
+size_t Pathfinder::peakMemoryBytes(size_t nodeCount) const
+{
+    const size_t perNode = sizeof(Record) + sizeof(uint32_t);
+    return nodeCount * perNode + (size_t)(m_peakOpen + m_peakIncons) * sizeof(Node*);
+}
+
+void Pathfinder::setSearchMask(const std::vector<char>* mask, int cols)
+{
+    m_mask = mask;
+    m_maskCols = cols;
+}
+
+void Pathfinder::setClearance(const std::vector<uint8_t>* clearance, int cols, int size)
+{
+    m_clearance = clearance;
+    m_clearanceCols = cols;
+    m_agentSize = size;
+}
+
+void Pathfinder::setGraph(const CsrGraph* graph, const std::vector<Node*>* nodes)
+{
+    m_graph = (graph && nodes) ? graph : nullptr;
+    m_graphNodes = m_graph ? nodes : nullptr;
+    m_hScale = m_graph ? m_graph->heuristicScale() : 1.0f;
+}
+
+void Pathfinder::setExactHeuristic(const std::vector<int>* dist, int cols, int unreachable)
+{
+    m_exactH = dist;
+    m_exactCols = cols;
+    m_exactUnreachable = unreachable;
 }
 
 void Pathfinder::cancel()
 {
     m_open.clear();
+    m_incons.clear();
     m_start = nullptr;
     m_goal = nullptr;
 }
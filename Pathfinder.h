@@ -1,20 +1,172 @@
 #pragma once
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 #include "Node.h"
+#include "Path.h"
+#include "CsrGraph.h"
+
+class Grid;
 
 class Pathfinder
 {
 public:
     enum class Result { Running, Found, NoPath };
 
+    // Optimal: plain A*. Weighted: f = g + eps*h, paths at most eps times longer.
+    // Anytime (ARA*): step() returns Found once per epsilon round; improve() then
+    // lowers epsilon and repairs the previous search instead of starting over.
+    enum class Mode { Optimal, Weighted, Anytime };
+
+    // What one budgeted slice of the search did
+    struct Progress
+    {
+        Result result = Result::Running;   // Running: budget used up, call again to resume
+        int expansions = 0;
+        double elapsedUs = 0.0;
+    };
+
+    void setMode(Mode mode, float epsilon);
+    Mode mode() const { return m_mode; }
+
+    // Search records live in the Pathfinder (one per cell of a rows x cols grid,
+    // reset lazily per search). The goal-set start() sets it itself; call it
+    // before the single-goal start().
+    void setGridSize(int rows, int cols);
+
+    // With writesNodes off the search leaves every Node untouched (no g/h/f/parent
+    // mirror, no Open/Closed painting), so several Pathfinders can share one Grid.
+    void setWritesNodes(bool on) { m_writeNodes = on; }
+
+    // Optional movement graph: neighbours and step costs come from its arcs
+    // (nodes[cell] maps a graph node back to its Node) instead of Node::neighbors.
+    // The Manhattan heuristic is scaled by graph->heuristicScale() so arcs that
+    // cover more ground than they cost (teleporters) keep it admissible.
+    void setGraph(const CsrGraph* graph, const std::vector<Node*>* nodes);
+    void clearGraph() { m_graph = nullptr; m_graphNodes = nullptr; m_hScale = 1.0f; }
+
     void start(Node* start, Node* goal);
+
+    // Nearest-of-many: stops at whichever goal is reached first. The heuristic is
+    // an L1 distance transform of the goals over the rows x cols grid, built once
+    // per goal set and read in O(1) per node.
+    void start(Node* start, const std::vector<Node*>& goals, int rows, int cols);
     Result step();
     void cancel();
 
+    // Keeps stepping until the search stops (or ARA* finishes a round), maxExpansions
+    // nodes were expanded, or maxMicros have passed. A limit <= 0 is no limit. All
+    // state stays in the Pathfinder, so the next call picks up where this one ended.
+    Progress stepFor(int maxExpansions, double maxMicros = 0.0);
+
+    // --- Anytime (ARA*) ---
+    bool canImprove() const;
+    bool improve(float epsStep = 0.5f);
+    float epsilon() const { return m_eps; }
+    float suboptimalityBound() const;   // proven cost(path) / cost(optimal) upper bound
+
+    // Optional search restriction: only cells with mask[row*cols+col] != 0 are expanded
+    void setSearchMask(const std::vector<char>* mask, int cols);
+    void clearSearchMask() { m_mask = nullptr; }
+
+    // Empty-box shortcut: when the Start/Goal bounding box has no walls in the
+    // grid's wall table, the first step() lays down an L-shaped path and returns
+    // Found without expanding anything. Single goal, one-cell agent and plain
+    // grid moves only: leave it unset when a movement graph adds or cuts arcs.
+    void setWallTable(const Grid* grid) { m_wallGrid = grid; }
+    bool usedEmptyBox() const { return m_emptyBox; }
+
+    // Agents larger than one cell: a cell is entered only if clearance[row*cols+col]
+    // >= size (see ClearanceMap; the cell is the agent's top-left corner). The
+    // values are read, not copied.
+    void setClearance(const std::vector<uint8_t>* clearance, int cols, int size);
+    void clearClearance() { m_clearance = nullptr; m_agentSize = 1; }
+    int agentSize() const { return m_agentSize; }
+
+    // Perfect heuristic: dist[row*cols+col] is the true distance to the nearest goal
+    // (a goal-rooted BFS). A* then expands only cells on optimal paths, and cells at
+    // or above unreachable are never generated. The field is read, not copied.
+    void setExactHeuristic(const std::vector<int>* dist, int cols, int unreachable);
+    void clearExactHeuristic() { m_exactH = nullptr; }
+    bool usesExactHeuristic() const { return m_exactH != nullptr; }
+
+    // Goal the search ended on (the single goal, or the nearest one of a goal set)
+    Node* reachedGoal() const { return m_goal; }
+
+    // Start to the reached goal after step() returned Found (empty otherwise)
+    Path path() const;
+
+    int expandedCount() const { return m_expanded; }
+    int peakOpenSize() const { return m_peakOpen; }
+
+    // Search state A* keeps for nodeCount nodes (one record per cell) plus the open and
+    // ARA* inconsistent list peaks
+    size_t peakMemoryBytes(size_t nodeCount) const;
+
 private:
     float heuristic(const Node* a, const Node* b) const;
+    float heuristic(const Node* n) const;
+    bool isGoal(const Node* n) const;
+    void relax(Node* current, Node* nb, float cost);
+    void buildGoalField(const std::vector<Node*>& goals, int rows, int cols);
+    bool layEmptyBoxPath();
+    struct Record
+    {
+        float g = 1e9f;
+        float h = 0.0f;
+        float f = 1e9f;
+        Node* parent = nullptr;
+        uint16_t closedRound = 0;   // closed in this ARA* round when == m_round
+        bool open = false;
+        bool incons = false;        // ARA*: listed in m_incons
+    };
+
+    int cellOf(const Node* n) const { return n->row * m_cols + n->col; }
+    Record& rec(const Node* n);               // fresh defaults the first time per search
+    const Record& peek(const Node* n) const;  // read-only, untouched nodes read as defaults
+    void sync(Node* n, const Record& r) const;
+    float key(const Record& r) const { return r.g + m_eps * r.h; }
+
+    Mode m_mode = Mode::Optimal;
+    float m_eps = 1.0f;
+    float m_epsStart = 1.0f;
+
+    int m_cols = 0;
+    std::vector<Record> m_rec;
+    std::vector<uint32_t> m_recStamp;
+    uint32_t m_stamp = 0;
+    bool m_writeNodes = true;
 
     std::vector<Node*> m_open;
+    std::vector<Node*> m_incons;   // ARA*: improved after being closed this round
+    uint16_t m_round = 1;          // bumping it reopens every closed record at once
+    int m_peakIncons = 0;
     Node* m_start = nullptr;
     Node* m_goal = nullptr;
+
+    // Multi-goal: distance to the nearest goal ignoring walls, 0 exactly on goals
+    std::vector<Node*> m_goalSet;
+    std::vector<int> m_goalField;
+    int m_fieldCols = 0;
+    bool m_multiGoal = false;
+
+    const CsrGraph* m_graph = nullptr;
+    const std::vector<Node*>* m_graphNodes = nullptr;
+    float m_hScale = 1.0f;
+
+    const std::vector<char>* m_mask = nullptr;
+    int m_maskCols = 0;
+
+    const Grid* m_wallGrid = nullptr;
+    bool m_emptyBox = false;
+
+    const std::vector<uint8_t>* m_clearance = nullptr;
+    int m_clearanceCols = 0;
+    int m_agentSize = 1;
+
+    const std::vector<int>* m_exactH = nullptr;
+    int m_exactCols = 0;
+    int m_exactUnreachable = 0;
+    int m_expanded = 0;
+    int m_peakOpen = 0;
 };
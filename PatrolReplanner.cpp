@@ -0,0 +1,301 @@
+#include "PatrolReplanner.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+static const int DR[4] = { -1, 1, 0, 0 };
+static const int DC[4] = { 0, 0, -1, 1 };
+
+void PatrolReplanner::clear()
+{
+    m_grid = nullptr;
+    m_route.clear();
+    m_routeIndex.clear();
+    m_patrols.clear();
+    m_occupied.clear();
+    m_g.clear();
+    m_parent.clear();
+    m_seen.clear();
+    m_closed.clear();
+    m_open.clear();
+    m_searching = false;
+    m_goal = m_runner = -1;
+}
+
+void PatrolReplanner::reset(const Grid& grid, int startCell, int goalCell)
+{
+    clear();
+    m_grid = &grid;
+    m_cols = grid.cols();
+    m_goal = goalCell;
+    m_runner = startCell;
+
+    const int n = grid.rows() * m_cols;
+    m_routeIndex.assign(n, -1);
+    m_occupied.assign(n, 0);
+    m_g.assign(n, 0);
+    m_parent.assign(n, -1);
+    m_seen.assign(n, 0);
+    m_closed.assign(n, 0);
+    m_stamp = 0;
+
+    m_replans = m_waits = 0;
+    m_lastExpansions = m_lastFrames = 0;
+
+    // First plan: an empty route forces a full search on the next frame
+    setRoute({ startCell });
+    startReplan();
+}
+
+void PatrolReplanner::restartRunner(int startCell)
+{
+    if (!active()) return;
+    m_runner = startCell;
+    setRoute({ startCell });
+    startReplan();
+}
+
+void PatrolReplanner::addPatrol(const std::vector<int>& route)
+{
+    if (!active() || route.empty()) return;
+
+    Patrol p;
+    p.route = route;
+    p.cell = route.front();
+    m_occupied[p.cell]++;
+    m_patrols.push_back(p);
+}
+
+bool PatrolReplanner::free(int cell) const
+{
+    const Node* n = m_grid->getNode(cell / m_cols, cell % m_cols);
+    return n && n->walkable && m_occupied[cell] == 0;
+}
+
+int PatrolReplanner::heuristic(int cell) const
+{
+    return std::abs(cell / m_cols - m_goal / m_cols) + std::abs(cell % m_cols - m_goal % m_cols);
+}
+
+void PatrolReplanner::setRoute(std::vector<int> route)
+{
+    for (int cell : m_route)
+        m_routeIndex[cell] = -1;
+
+    m_route = std::move(route);
+    m_pos = 0;
+    m_routeWalls.clear();
+    for (int i = 0; i < (int)m_route.size(); i++)
+        m_routeIndex[m_route[i]] = i;
+}
+
+std::vector<int> PatrolReplanner::remainingRoute() const
+{
+    if (m_pos >= (int)m_route.size()) return {};
+    return std::vector<int>(m_route.begin() + m_pos, m_route.end());
+}
+
+void PatrolReplanner::startReplan(int wallIndex)
+{
+    // Keep walking a short committed prefix, but never into the first blocked cell.
+    // Walls stay on the route until it is replaced, so a restarted replan must still
+    // avoid the ones seen before: the reused tail may only start behind all of them.
+    if (wallIndex > m_pos)
+        m_routeWalls.push_back(wallIndex);
+
+    int firstBlocked = (int)m_route.size();
+    int lastBlocked = m_pos;
+    for (int i : m_routeWalls)
+    {
+        if (i <= m_pos) continue;
+        firstBlocked = std::min(firstBlocked, i);
+        lastBlocked = std::max(lastBlocked, i);
+    }
+    for (const Patrol& p : m_patrols)
+    {
+        const int i = m_routeIndex[p.cell];
+        if (i > m_pos)
+        {
+            firstBlocked = std::min(firstBlocked, i);
+            lastBlocked = std::max(lastBlocked, i);
+        }
+    }
+
+    m_commitIndex = std::min({ m_pos + COMMIT, firstBlocked - 1, (int)m_route.size() - 1 });
+    m_commitIndex = std::max(m_commitIndex, m_pos);
+    m_rejoinFrom = std::max(lastBlocked, m_commitIndex);
+    m_searchStart = m_route[m_commitIndex];
+
+    if (++m_stamp == 0)
+    {
+        std::fill(m_seen.begin(), m_seen.end(), 0);
+        std::fill(m_closed.begin(), m_closed.end(), 0);
+        m_stamp = 1;
+    }
+    m_open.clear();
+
+    m_g[m_searchStart] = 0;
+    m_parent[m_searchStart] = -1;
+    m_seen[m_searchStart] = m_stamp;
+    m_open.push_back({ heuristic(m_searchStart), 0, m_searchStart, -1 });
+
+    m_searching = true;
+    m_expansions = 0;
+    m_frames = 0;
+}
+
+void PatrolReplanner::finishReplan(int endCell, int rejoin)
+{
+    std::vector<int> detour;
+    for (int v = endCell; v != -1; v = m_parent[v])
+        detour.push_back(v);
+    std::reverse(detour.begin(), detour.end());
+
+    // Committed prefix + new detour + reused tail of the old route
+    std::vector<int> route(m_route.begin() + m_pos, m_route.begin() + m_commitIndex);
+    route.insert(route.end(), detour.begin(), detour.end());
+    if (rejoin >= 0)
+        route.insert(route.end(), m_route.begin() + rejoin + 1, m_route.end());
+
+    setRoute(std::move(route));
+
+    m_searching = false;
+    m_replans++;
+    m_lastExpansions = m_expansions;
+    m_lastFrames = m_frames;
+}
+
+void PatrolReplanner::frame(int maxExpansions)
+{
+    if (!m_searching) return;
+    m_frames++;
+
+    for (int budget = maxExpansions; budget > 0; )
+    {
+        if (m_open.empty())
+        {
+            // Boxed in for now; the next tick tries again with the patrols moved
+            m_searching = false;
+            return;
+        }
+
+        std::pop_heap(m_open.begin(), m_open.end(), std::greater<OpenEntry>());
+        const OpenEntry e = m_open.back();
+        m_open.pop_back();
+
+        if (e.rejoin >= 0)
+        {
+            finishReplan(e.cell, e.rejoin);
+            return;
+        }
+        if (m_closed[e.cell] == m_stamp || e.g != m_g[e.cell]) continue;
+        m_closed[e.cell] = m_stamp;
+        m_expansions++;
+        budget--;
+
+        if (e.cell == m_goal)
+        {
+            finishReplan(e.cell, -1);
+            return;
+        }
+
+        const int r = e.cell / m_cols;
+        const int c = e.cell % m_cols;
+        for (int d = 0; d < 4; d++)
+        {
+            const Node* nb = m_grid->getNode(r + DR[d], c + DC[d]);
+            if (!nb) continue;
+
+            const int v = nb->row * m_cols + nb->col;
+            if (!free(v) || m_closed[v] == m_stamp) continue;
+
+            const int g = e.g + 1;
+            if (m_seen[v] == m_stamp && g >= m_g[v]) continue;
+
+            m_seen[v] = m_stamp;
+            m_g[v] = g;
+            m_parent[v] = e.cell;
+            m_open.push_back({ g + heuristic(v), g, v, -1 });
+            std::push_heap(m_open.begin(), m_open.end(), std::greater<OpenEntry>());
+
+            // Behind the blockage the old route is still good: offer it as a finish
+            const int j = m_routeIndex[v];
+            if (j > m_rejoinFrom)
+            {
+                m_open.push_back({ g + (int)m_route.size() - 1 - j, g, v, j });
+                std::push_heap(m_open.begin(), m_open.end(), std::greater<OpenEntry>());
+            }
+        }
+    }
+}
+
+void PatrolReplanner::tick()
+{
+    if (!active()) return;
+
+    // Patrols first; they never step onto the runner or a wall
+    for (Patrol& p : m_patrols)
+    {
+        if (p.route.size() < 2) continue;
+
+        int next = p.index + p.dir;
+        if (next < 0 || next >= (int)p.route.size())
+        {
+            p.dir = -p.dir;
+            next = p.index + p.dir;
+        }
+
+        const int cell = p.route[next];
+        const Node* n = m_grid->getNode(cell / m_cols, cell % m_cols);
+        if (cell == m_runner || !n || !n->walkable) continue;
+
+        m_occupied[p.cell]--;
+        p.index = next;
+        p.cell = cell;
+        m_occupied[p.cell]++;
+    }
+
+    if (arrived()) return;
+
+    // A patrol on the part still ahead invalidates the route
+    bool blocked = false;
+    for (const Patrol& p : m_patrols)
+        if (m_routeIndex[p.cell] > m_pos) { blocked = true; break; }
+
+    if (blocked && !m_searching)
+        startReplan();
+
+    // So does a static wall right in front (placed while no replan could see it)
+    if (!m_searching && m_pos + 1 < (int)m_route.size())
+    {
+        const int next = m_route[m_pos + 1];
+        const Node* n = m_grid->getNode(next / m_cols, next % m_cols);
+        if (!n || !n->walkable) startReplan(m_pos + 1);
+    }
+
+    // Walk on, but only within the committed prefix while a replan is running
+    const int limit = m_searching ? m_commitIndex : (int)m_route.size() - 1;
+    if (m_pos < limit && free(m_route[m_pos + 1]))
+    {
+        m_pos++;
+        m_runner = m_route[m_pos];
+    }
+    else
+    {
+        m_waits++;
+        if (!m_searching && m_pos >= (int)m_route.size() - 1 && m_runner != m_goal)
+            startReplan();   // route ended early (first plan failed): keep trying
+    }
+}
+
+void PatrolReplanner::onWallToggled(int cell)
+{
+    if (!active()) return;
+
+    const Node* n = m_grid->getNode(cell / m_cols, cell % m_cols);
+    if (!n || n->walkable) return;   // an opened cell never breaks the route
+
+    // Restart even a running replan: its reused tail may cross the new wall
+    if (m_routeIndex[cell] > m_pos)
+        startReplan(m_routeIndex[cell]);
+}
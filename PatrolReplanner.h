@@ -0,0 +1,100 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Grid.h"
+
+// A runner walking Start -> Goal while patrols (moving walls) walk back and
+// forth along fixed routes, one cell per tick.
+//
+// The runner's route is only replanned when a patrol stands on the part it has
+// not walked yet. Replanning is spread over frames with a fixed expansion
+// budget. The runner keeps walking the first cells of the old route (the
+// committed prefix) meanwhile, and the new search may rejoin the old route
+// behind the blocked cells, so the still-valid tail of the previous plan is
+// reused instead of being searched again. Per-frame cost depends on the budget
+// and the patrol count only, not on the grid size.
+class PatrolReplanner
+{
+public:
+    struct Patrol
+    {
+        std::vector<int> route;   // cells walked back and forth
+        int index = 0;
+        int dir = 1;
+        int cell = -1;
+    };
+
+    void reset(const Grid& grid, int startCell, int goalCell);
+    void restartRunner(int startCell);   // keeps the patrols where they are
+    void clear();
+    void addPatrol(const std::vector<int>& route);
+
+    void tick();                      // patrols and runner move one cell
+    void frame(int maxExpansions);    // continue a pending replan within the budget
+    void onWallToggled(int cell);     // static wall edits can invalidate the route too
+
+    bool active() const { return m_grid != nullptr; }
+    bool arrived() const { return m_runner == m_goal; }
+    bool searching() const { return m_searching; }
+    int runnerCell() const { return m_runner; }
+
+    // Cells still ahead of the runner (the first one is the runner's cell)
+    std::vector<int> remainingRoute() const;
+    const std::vector<Patrol>& patrols() const { return m_patrols; }
+
+    int replans() const { return m_replans; }
+    int lastReplanExpansions() const { return m_lastExpansions; }
+    int lastReplanFrames() const { return m_lastFrames; }
+    int waits() const { return m_waits; }
+
+    static constexpr int COMMIT = 3;   // cells the runner may keep walking during a replan
+
+private:
+    struct OpenEntry
+    {
+        int f, g, cell, rejoin;   // rejoin: old route index to continue on, -1 otherwise
+        bool operator>(const OpenEntry& o) const
+        {
+            if (f != o.f) return f > o.f;
+            return g < o.g;
+        }
+    };
+
+    bool free(int cell) const;
+    int heuristic(int cell) const;
+    void startReplan(int wallIndex = -1);   // wallIndex: route index of a new static wall
+    void finishReplan(int endCell, int rejoin);
+    void setRoute(std::vector<int> route);
+
+    const Grid* m_grid = nullptr;
+    int m_cols = 0;
+    int m_goal = -1;
+    int m_runner = -1;
+
+    std::vector<int> m_route;        // full current route, m_route[m_pos] is the runner
+    int m_pos = 0;
+    std::vector<int> m_routeIndex;   // cell -> index in m_route, -1 if not on it
+    std::vector<int> m_routeWalls;   // indices in m_route of static walls placed since it was set
+
+    std::vector<Patrol> m_patrols;
+    std::vector<uint16_t> m_occupied;   // patrols per cell
+
+    // Budgeted search state (stamp-reset, never cleared in O(cells))
+    bool m_searching = false;
+    int m_searchStart = -1;
+    int m_commitIndex = 0;           // route index the search starts from
+    int m_rejoinFrom = 0;            // old route indices above this may be rejoined
+    std::vector<int> m_g;
+    std::vector<int> m_parent;
+    std::vector<uint32_t> m_seen;
+    std::vector<uint32_t> m_closed;
+    uint32_t m_stamp = 0;
+    std::vector<OpenEntry> m_open;   // binary heap; capacity survives between replans
+
+    int m_replans = 0;
+    int m_expansions = 0;
+    int m_frames = 0;
+    int m_lastExpansions = 0;
+    int m_lastFrames = 0;
+    int m_waits = 0;
+};
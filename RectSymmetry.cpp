@@ -0,0 +1,262 @@
+#include "RectSymmetry.h"
+#include <algorithm>
+#include <cmath>
+
+void RectSymmetry::clear()
+{
+    cancel();
+    m_rects.clear();
+    m_rectAlive.clear();
+    m_rectOf.clear();
+    m_deadRects = 0;
+    m_g.clear();
+    m_parent.clear();
+    m_seen.clear();
+    m_closed.clear();
+    m_stamp = 0;
+}
+
+void RectSymmetry::build(Grid& grid)
+{
+    clear();
+    m_grid = &grid;
+    m_rows = grid.rows();
+    m_cols = grid.cols();
+
+    RoomGraph::decompose(grid, m_rects, m_rectOf);
+    m_rectAlive.assign(m_rects.size(), 1);
+
+    const int n = m_rows * m_cols;
+    m_g.assign(n, 0);
+    m_parent.assign(n, -1);
+    m_seen.assign(n, 0);
+    m_closed.assign(n, 0);
+}
+
+void RectSymmetry::onWallToggled(int r, int c)
+{
+    if (!m_grid || empty()) return;
+
+    const int x = r * m_cols + c;
+    const Node* center = m_grid->getNode(r, c);
+    if (!center) return;
+
+    // Dissolve the rectangle holding the cell, and if the cell opened up, the
+    // rectangles around it so the new free cell can merge into a bigger one.
+    std::vector<int> dissolve;
+    if (m_rectOf[x] >= 0) dissolve.push_back(m_rectOf[x]);
+    if (center->walkable)
+    {
+        for (const Node* nb : center->neighbors)
+        {
+            if (!nb || !nb->walkable) continue;
+            const int id = m_rectOf[nb->row * m_cols + nb->col];
+            if (id >= 0 && std::find(dissolve.begin(), dissolve.end(), id) == dissolve.end())
+                dissolve.push_back(id);
+        }
+    }
+
+    RoomGraph::Room box;
+    box.r0 = box.r1 = r;
+    box.c0 = box.c1 = c;
+    for (int id : dissolve)
+    {
+        const RoomGraph::Room& rect = m_rects[id];
+        box.r0 = std::min(box.r0, rect.r0); box.c0 = std::min(box.c0, rect.c0);
+        box.r1 = std::max(box.r1, rect.r1); box.c1 = std::max(box.c1, rect.c1);
+
+        for (int rr = rect.r0; rr <= rect.r1; rr++)
+            for (int cc = rect.c0; cc <= rect.c1; cc++)
+                m_rectOf[rr * m_cols + cc] = -1;
+
+        m_rectAlive[id] = 0;
+        m_deadRects++;
+    }
+    m_rectOf[x] = -1;
+
+    // Cells of untouched rectangles inside the box keep their id and are skipped
+    RoomGraph::decomposeRegion(*m_grid, box, m_rects, m_rectOf);
+    m_rectAlive.resize(m_rects.size(), 1);
+
+    // Too many stale entries: start from a clean cover
+    if (m_deadRects > rectCount())
+        build(*m_grid);
+}
+
+bool RectSymmetry::isPerimeter(int cell) const
+{
+    const RoomGraph::Room& rect = m_rects[m_rectOf[cell]];
+    const int r = cell / m_cols;
+    const int c = cell % m_cols;
+    return r == rect.r0 || r == rect.r1 || c == rect.c0 || c == rect.c1;
+}
+
+int RectSymmetry::heuristic(int cell) const
+{
+    return std::abs(cell / m_cols - m_goalCell / m_cols) + std::abs(cell % m_cols - m_goalCell % m_cols);
+}
+
+void RectSymmetry::start(Node* start, Node* goal)
+{
+    cancel();
+    if (!m_grid || !start || !goal || empty()) return;
+
+    m_startCell = start->row * m_cols + start->col;
+    m_goalCell = goal->row * m_cols + goal->col;
+    if (m_rectOf[m_startCell] < 0 || m_rectOf[m_goalCell] < 0)
+    {
+        m_startCell = m_goalCell = -1;
+        return;
+    }
+
+    // Wall-free bounding box: the L-shaped path is optimal, skip the search
+    if (!m_grid->anyWall(start->row, start->col, goal->row, goal->col))
+    {
+        m_path = Path::lShape(m_startCell, m_goalCell, m_cols);
+        m_emptyBox = true;
+        return;
+    }
+
+    if (++m_stamp == 0)
+    {
+        std::fill(m_seen.begin(), m_seen.end(), 0);
+        std::fill(m_closed.begin(), m_closed.end(), 0);
+        m_stamp = 1;
+    }
+
+    m_g[m_startCell] = 0;
+    m_parent[m_startCell] = -1;
+    m_seen[m_startCell] = m_stamp;
+
+    const int h = heuristic(m_startCell);
+    m_open.push({ h, h, m_startCell });
+}
+
+void RectSymmetry::push(int from, int to, int cost)
+{
+    if (m_closed[to] == m_stamp) return;
+
+    const int g = m_g[from] + cost;
+    if (m_seen[to] == m_stamp && g >= m_g[to]) return;
+
+    m_seen[to] = m_stamp;
+    m_g[to] = g;
+    m_parent[to] = from;
+
+    const int h = heuristic(to);
+    m_open.push({ g + h, h, to });
+
+    Node* n = m_grid->getNode(to / m_cols, to % m_cols);
+    if (to != m_startCell && to != m_goalCell)
+        n->state = NodeVizState::Open;
+}
+
+Pathfinder::Result RectSymmetry::step()
+{
+    if (m_startCell < 0 || m_goalCell < 0) return Pathfinder::Result::NoPath;
+    if (m_emptyBox) return Pathfinder::Result::Found;
+
+    // Skip entries that were superseded by a cheaper push
+    while (!m_open.empty())
+    {
+        const OpenEntry& top = m_open.top();
+        if (m_closed[top.cell] != m_stamp && top.f == m_g[top.cell] + top.h) break;
+        m_open.pop();
+    }
+    if (m_open.empty()) return Pathfinder::Result::NoPath;
+
+    const int u = m_open.top().cell;
+    m_open.pop();
+    m_closed[u] = m_stamp;
+    m_expanded++;
+
+    if (u != m_startCell && u != m_goalCell)
+        m_grid->getNode(u / m_cols, u % m_cols)->state = NodeVizState::Closed;
+
+    if (u == m_goalCell)
+    {
+        buildPath();
+        return Pathfinder::Result::Found;
+    }
+
+    const int r = u / m_cols;
+    const int c = u % m_cols;
+    const int id = m_rectOf[u];
+    const RoomGraph::Room& rect = m_rects[id];
+    const int goalRow = m_goalCell / m_cols;
+    const int goalCol = m_goalCell % m_cols;
+    const bool goalInRect = (m_rectOf[m_goalCell] == id);
+
+    if (!isPerimeter(u))
+    {
+        // Only the Start can sit inside a rectangle: connect it to the four sides
+        push(u, rect.r0 * m_cols + c, r - rect.r0);
+        push(u, rect.r1 * m_cols + c, rect.r1 - r);
+        push(u, r * m_cols + rect.c0, c - rect.c0);
+        push(u, r * m_cols + rect.c1, rect.c1 - c);
+    }
+    else
+    {
+        // Ordinary moves, except into the interior of the own rectangle
+        for (const Node* nb : m_grid->getNode(r, c)->neighbors)
+        {
+            if (!nb || !nb->walkable) continue;
+            const int v = nb->row * m_cols + nb->col;
+            if (m_rectOf[v] == id && !isPerimeter(v)) continue;
+            push(u, v, 1);
+        }
+
+        // Macro edges straight across the rectangle
+        if (rect.c1 > rect.c0)
+        {
+            if (c == rect.c0) push(u, r * m_cols + rect.c1, rect.c1 - rect.c0);
+            if (c == rect.c1) push(u, r * m_cols + rect.c0, rect.c1 - rect.c0);
+        }
+        if (rect.r1 > rect.r0)
+        {
+            if (r == rect.r0) push(u, rect.r1 * m_cols + c, rect.r1 - rect.r0);
+            if (r == rect.r1) push(u, rect.r0 * m_cols + c, rect.r1 - rect.r0);
+        }
+    }
+
+    // A Goal inside a rectangle is reached from its own row/column on the perimeter,
+    // or directly from a Start in the same rectangle
+    if (goalInRect && (u == m_startCell || r == goalRow || c == goalCol))
+        push(u, m_goalCell, std::abs(r - goalRow) + std::abs(c - goalCol));
+
+    return Pathfinder::Result::Running;
+}
+
+void RectSymmetry::buildPath()
+{
+    std::vector<int> cells;
+
+    std::vector<int> waypoints;
+    for (int v = m_goalCell; v != -1; v = m_parent[v])
+        waypoints.push_back(v);
+    std::reverse(waypoints.begin(), waypoints.end());
+
+    // Macro edges jump; fill the cells in between (row first, then column)
+    cells.push_back(waypoints.front());
+    for (size_t i = 1; i < waypoints.size(); i++)
+    {
+        int r = waypoints[i - 1] / m_cols;
+        int c = waypoints[i - 1] % m_cols;
+        const int tr = waypoints[i] / m_cols;
+        const int tc = waypoints[i] % m_cols;
+
+        while (c != tc) { c += (tc > c) ? 1 : -1; cells.push_back(r * m_cols + c); }
+        while (r != tr) { r += (tr > r) ? 1 : -1; cells.push_back(r * m_cols + c); }
+    }
+    m_path = Path(std::move(cells), m_cols);
+}
+
+void RectSymmetry::cancel()
+{
+    while (!m_open.empty()) m_open.pop();
+    m_startCell = -1;
+    m_goalCell = -1;
+    m_expanded = 0;
+    m_emptyBox = false;
+    m_path.clear();
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include "Grid.h"
+#include "RoomGraph.h"
+#include "Pathfinder.h"
+
+// Rectangular Symmetry Reduction (RSR) for 4-connected grids.
+//
+// Free space is covered by wall-free rectangles. Interior cells are never
+// expanded: the search only visits rectangle perimeters, plus "macro" edges that
+// jump straight across a rectangle. Every symmetric path through an empty
+// rectangle collapses into one, and the result stays optimal.
+class RectSymmetry
+{
+public:
+    void build(Grid& grid);
+    void clear();
+
+    // Local rebuild after the wall at (r, c) was toggled: only the rectangles
+    // touching that cell are dissolved and covered again.
+    void onWallToggled(int r, int c);
+
+    void start(Node* start, Node* goal);
+    Pathfinder::Result step();
+    void cancel();
+
+    bool empty() const { return m_rects.empty(); }
+    int expandedCount() const { return m_expanded; }
+    bool usedEmptyBox() const { return m_emptyBox; }   // no walls between Start and Goal: no search ran
+    int rectCount() const { return (int)m_rects.size() - m_deadRects; }
+    const std::vector<RoomGraph::Room>& rects() const { return m_rects; }
+    bool rectAlive(int id) const { return m_rectAlive[id] != 0; }
+
+    // Start to Goal after step() returned Found, macro edges filled in cell by cell
+    const Path& path() const { return m_path; }
+
+private:
+    struct OpenEntry
+    {
+        int f, h, cell;
+        bool operator>(const OpenEntry& o) const
+        {
+            if (f != o.f) return f > o.f;
+            return h > o.h;
+        }
+    };
+
+    bool isPerimeter(int cell) const;
+    int heuristic(int cell) const;
+    void push(int from, int to, int cost);
+    void buildPath();
+
+    Grid* m_grid = nullptr;
+    int m_rows = 0;
+    int m_cols = 0;
+
+    std::vector<RoomGraph::Room> m_rects;
+    std::vector<char> m_rectAlive;
+    std::vector<int> m_rectOf;
+    int m_deadRects = 0;
+
+    // Search scratch, reset in O(1) per query through the stamp
+    std::vector<int> m_g;
+    std::vector<int> m_parent;
+    std::vector<uint32_t> m_seen;
+    std::vector<uint32_t> m_closed;
+    uint32_t m_stamp = 0;
+
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> m_open;
+    int m_startCell = -1;
+    int m_goalCell = -1;
+    int m_expanded = 0;
+    bool m_emptyBox = false;
+    Path m_path;
+};
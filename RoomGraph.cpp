@@ -0,0 +1,368 @@
+#include "RoomGraph.h"
+#include <queue>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+void RoomGraph::clear()
+{
+    m_rows = 0;
+    m_cols = 0;
+    m_rooms.clear();
+    m_roomOf.clear();
+    m_portals.clear();
+    m_roomPortals.clear();
+    m_route.clear();
+    m_lowerBound = -1;
+}
+
+void RoomGraph::decompose(const Grid& grid, std::vector<Room>& rooms, std::vector<int>& roomOf)
+{
+    rooms.clear();
+    roomOf.assign(grid.rows() * grid.cols(), -1);
+
+    Room all;
+    all.r1 = grid.rows() - 1;
+    all.c1 = grid.cols() - 1;
+    decomposeRegion(grid, all, rooms, roomOf);
+}
+
+// Largest n in [1, limit] with ok(n), for an ok that holds for 1 and stays true up to
+// some n and false after it: doubling steps, then a binary search
+template <typename Ok>
+static int longestRun(int limit, Ok ok)
+{
+    int lo = 1;
+    int step = 1;
+    while (lo + step <= limit && ok(lo + step))
+    {
+        lo += step;
+        step *= 2;
+    }
+    int hi = std::min(lo + step, limit + 1);   // first n known (or assumed) to fail
+    while (hi - lo > 1)
+    {
+        const int mid = (lo + hi) / 2;
+        if (ok(mid)) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void RoomGraph::decomposeRegion(const Grid& grid, const Room& box,
+    std::vector<Room>& rooms, std::vector<int>& roomOf)
+{
+    const int cols = grid.cols();
+
+    // Walls come from the grid's summed-area table, a whole span in one query, so
+    // growing a rectangle reads only the room ids per cell, never the nodes
+    auto noWall = [&](int r0, int c0, int r1, int c1) { return !grid.anyWall(r0, c0, r1, c1); };
+    auto unclaimedRow = [&](int r, int c0, int c1)
+        {
+            for (int c = c0; c <= c1; c++)
+                if (roomOf[r * cols + c] >= 0) return false;
+            return true;
+        };
+    auto unclaimedCol = [&](int c, int r0, int r1)
+        {
+            for (int r = r0; r <= r1; r++)
+                if (roomOf[r * cols + c] >= 0) return false;
+            return true;
+        };
+
+    for (int r = box.r0; r <= box.r1; r++)
+    {
+        for (int c = box.c0; c <= box.c1; c++)
+        {
+            if (roomOf[r * cols + c] >= 0 || !noWall(r, c, r, c)) continue;
+
+            // Option A: grow right first, then extend the whole span down
+            int wA = longestRun(box.c1 - c + 1, [&](int w) { return noWall(r, c, r, c + w - 1); });
+            for (int k = 1; k < wA; k++)
+                if (roomOf[r * cols + c + k] >= 0) { wA = k; break; }
+            const int hWallA = longestRun(box.r1 - r + 1, [&](int h) { return noWall(r, c, r + h - 1, c + wA - 1); });
+            int hA = 1;
+            while (hA < hWallA && unclaimedRow(r + hA, c, c + wA - 1)) hA++;
+
+            // Option B: grow down first, then extend the whole span right
+            int hB = longestRun(box.r1 - r + 1, [&](int h) { return noWall(r, c, r + h - 1, c); });
+            for (int k = 1; k < hB; k++)
+                if (roomOf[(r + k) * cols + c] >= 0) { hB = k; break; }
+            const int wWallB = longestRun(box.c1 - c + 1, [&](int w) { return noWall(r, c, r + hB - 1, c + w - 1); });
+            int wB = 1;
+            while (wB < wWallB && unclaimedCol(c + wB, r, r + hB - 1)) wB++;
+
+            Room room;
+            room.r0 = r;
+            room.c0 = c;
+            if (wA * hA >= wB * hB) { room.r1 = r + hA - 1; room.c1 = c + wA - 1; }
+            else                    { room.r1 = r + hB - 1; room.c1 = c + wB - 1; }
+
+            const int id = (int)rooms.size();
+            for (int rr = room.r0; rr <= room.r1; rr++)
+                for (int cc = room.c0; cc <= room.c1; cc++)
+                    roomOf[rr * cols + cc] = id;
+
+            rooms.push_back(room);
+        }
+    }
+}
+
+void RoomGraph::build(const Grid& grid)
+{
+    clear();
+    m_rows = grid.rows();
+    m_cols = grid.cols();
+
+    decompose(grid, m_rooms, m_roomOf);
+    buildPortals();
+}
+
+void RoomGraph::buildPortals()
+{
+    m_portals.clear();
+    m_roomPortals.assign(m_rooms.size(), {});
+
+    auto roomAt = [&](int r, int c)
+        {
+            if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return -1;
+            return m_roomOf[r * m_cols + c];
+        };
+
+    auto addPortal = [&](int a, int b, int cellA, int cellB, int width, const Room& spanA, const Room& spanB)
+        {
+            Portal p;
+            p.roomA = a; p.roomB = b;
+            p.cellA = cellA; p.cellB = cellB;
+            p.width = width;
+            p.spanA = spanA; p.spanB = spanB;
+
+            const int id = (int)m_portals.size();
+            m_portals.push_back(p);
+            m_roomPortals[a].push_back(id);
+            m_roomPortals[b].push_back(id);
+        };
+
+    // Only the right and bottom sides are scanned; the left/top sides of a room
+    // are the right/bottom sides of its neighbours.
+    for (int id = 0; id < (int)m_rooms.size(); id++)
+    {
+        const Room& room = m_rooms[id];
+
+        // right side: runs of the same neighbour room along column c1+1
+        for (int r = room.r0; r <= room.r1; )
+        {
+            const int nb = roomAt(r, room.c1 + 1);
+            int end = r;
+            while (end + 1 <= room.r1 && roomAt(end + 1, room.c1 + 1) == nb) end++;
+
+            if (nb >= 0)
+            {
+                const int mid = (r + end) / 2;
+                const Room spanA{ r, room.c1, end, room.c1 };
+                const Room spanB{ r, room.c1 + 1, end, room.c1 + 1 };
+                addPortal(id, nb, mid * m_cols + room.c1, mid * m_cols + room.c1 + 1, end - r + 1, spanA, spanB);
+            }
+            r = end + 1;
+        }
+
+        // bottom side: runs of the same neighbour room along row r1+1
+        for (int c = room.c0; c <= room.c1; )
+        {
+            const int nb = roomAt(room.r1 + 1, c);
+            int end = c;
+            while (end + 1 <= room.c1 && roomAt(room.r1 + 1, end + 1) == nb) end++;
+
+            if (nb >= 0)
+            {
+                const int mid = (c + end) / 2;
+                const Room spanA{ room.r1, c, room.r1, end };
+                const Room spanB{ room.r1 + 1, c, room.r1 + 1, end };
+                addPortal(id, nb, room.r1 * m_cols + mid, (room.r1 + 1) * m_cols + mid, end - c + 1, spanA, spanB);
+            }
+            c = end + 1;
+        }
+    }
+}
+
+bool RoomGraph::plan(const Node* start, const Node* goal, std::vector<char>& mask)
+{
+    m_route.clear();
+    m_lowerBound = -1;
+    mask.assign(m_rows * m_cols, 0);
+    if (!start || !goal || m_rooms.empty()) return false;
+
+    const int startCell = start->row * m_cols + start->col;
+    const int goalCell = goal->row * m_cols + goal->col;
+    const int startRoom = m_roomOf[startCell];
+    const int goalRoom = m_roomOf[goalCell];
+    if (startRoom < 0 || goalRoom < 0) return false;
+
+    // Abstract nodes: 0 = start, 1 = goal, 2+2p / 3+2p = the two sides of portal p.
+    const int nodeCount = 2 + 2 * (int)m_portals.size();
+
+    auto cellOf = [&](int v)
+        {
+            if (v == 0) return startCell;
+            if (v == 1) return goalCell;
+            const Portal& p = m_portals[(v - 2) / 2];
+            return ((v - 2) % 2 == 0) ? p.cellA : p.cellB;
+        };
+    auto roomOfNode = [&](int v)
+        {
+            if (v == 0) return startRoom;
+            if (v == 1) return goalRoom;
+            const Portal& p = m_portals[(v - 2) / 2];
+            return ((v - 2) % 2 == 0) ? p.roomA : p.roomB;
+        };
+    // Rooms are wall-free rectangles, so the distance inside one is exactly Manhattan
+    auto manhattan = [&](int a, int b)
+        {
+            return std::abs(a / m_cols - b / m_cols) + std::abs(a % m_cols - b % m_cols);
+        };
+
+    const int INF = std::numeric_limits<int>::max() / 4;
+    std::vector<int> dist(nodeCount, INF);
+    std::vector<int> prev(nodeCount, -1);
+
+    using Entry = std::pair<int, int>; // (f, node)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+    dist[0] = 0;
+    open.push({ manhattan(startCell, goalCell), 0 });
+
+    while (!open.empty())
+    {
+        const auto [f, v] = open.top();
+        open.pop();
+
+        const int cellV = cellOf(v);
+        if (f - manhattan(cellV, goalCell) > dist[v]) continue; // stale entry
+        if (v == 1) break;
+
+        auto relax = [&](int u, int cost)
+            {
+                if (dist[v] + cost < dist[u])
+                {
+                    dist[u] = dist[v] + cost;
+                    prev[u] = v;
+                    open.push({ dist[u] + manhattan(cellOf(u), goalCell), u });
+                }
+            };
+
+        const int room = roomOfNode(v);
+
+        // Walk through the room to any of its doorways (or to the goal)
+        for (int p : m_roomPortals[room])
+        {
+            const Portal& portal = m_portals[p];
+            const int side = (portal.roomA == room) ? 2 + 2 * p : 3 + 2 * p;
+            if (side != v) relax(side, manhattan(cellV, cellOf(side)));
+        }
+        if (room == goalRoom) relax(1, manhattan(cellV, goalCell));
+
+        // Step through the doorway this node sits on
+        if (v >= 2)
+        {
+            const int other = ((v - 2) % 2 == 0) ? v + 1 : v - 1;
+            relax(other, 1);
+        }
+    }
+
+    if (dist[1] >= INF) return false;
+
+    for (int v = 1; v != -1; v = prev[v])
+    {
+        const int room = roomOfNode(v);
+        if (m_route.empty() || m_route.back() != room)
+            m_route.push_back(room);
+    }
+    std::reverse(m_route.begin(), m_route.end());
+
+    for (int id : m_route)
+    {
+        const Room& room = m_rooms[id];
+        for (int r = room.r0; r <= room.r1; r++)
+            for (int c = room.c0; c <= room.c1; c++)
+                mask[r * m_cols + c] = 1;
+    }
+
+    m_lowerBound = spanLowerBound(startCell, goalCell, startRoom, goalRoom);
+    return true;
+}
+
+int RoomGraph::spanLowerBound(int startCell, int goalCell, int startRoom, int goalRoom) const
+{
+    // Same abstract graph as plan(), but a node stands for a whole doorway side and
+    // a walk through a room costs the closest distance between the two spans. Any
+    // real path crosses some chain of doorways at some of their cells, so no path is
+    // shorter than the cheapest chain here. The spans overlap in range, so the costs
+    // break the triangle inequality and this is plain Dijkstra, without a heuristic.
+    const int nodeCount = 2 + 2 * (int)m_portals.size();
+
+    auto cellRoom = [&](int cell)
+        {
+            const int r = cell / m_cols, c = cell % m_cols;
+            return Room{ r, c, r, c };
+        };
+    const Room startSpan = cellRoom(startCell);
+    const Room goalSpan = cellRoom(goalCell);
+
+    auto spanOf = [&](int v) -> const Room&
+        {
+            if (v == 0) return startSpan;
+            if (v == 1) return goalSpan;
+            const Portal& p = m_portals[(v - 2) / 2];
+            return ((v - 2) % 2 == 0) ? p.spanA : p.spanB;
+        };
+    auto roomOfNode = [&](int v)
+        {
+            if (v == 0) return startRoom;
+            if (v == 1) return goalRoom;
+            const Portal& p = m_portals[(v - 2) / 2];
+            return ((v - 2) % 2 == 0) ? p.roomA : p.roomB;
+        };
+    auto gap = [](int a0, int a1, int b0, int b1) { return std::max(0, std::max(b0 - a1, a0 - b1)); };
+    auto spanDist = [&](const Room& a, const Room& b)
+        {
+            return gap(a.r0, a.r1, b.r0, b.r1) + gap(a.c0, a.c1, b.c0, b.c1);
+        };
+
+    const int INF = std::numeric_limits<int>::max() / 4;
+    std::vector<int> dist(nodeCount, INF);
+
+    using Entry = std::pair<int, int>; // (dist, node)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    dist[0] = 0;
+    open.push({ 0, 0 });
+
+    while (!open.empty())
+    {
+        const auto [d, v] = open.top();
+        open.pop();
+        if (d > dist[v]) continue;
+        if (v == 1) return d;
+
+        auto relax = [&](int u, int cost)
+            {
+                if (d + cost < dist[u])
+                {
+                    dist[u] = d + cost;
+                    open.push({ dist[u], u });
+                }
+            };
+
+        const int room = roomOfNode(v);
+        for (int p : m_roomPortals[room])
+        {
+            const Portal& portal = m_portals[p];
+            const int side = (portal.roomA == room) ? 2 + 2 * p : 3 + 2 * p;
+            if (side != v) relax(side, spanDist(spanOf(v), spanOf(side)));
+        }
+        if (room == goalRoom) relax(1, spanDist(spanOf(v), goalSpan));
+
+        if (v >= 2)
+            relax(((v - 2) % 2 == 0) ? v + 1 : v - 1, 1);
+    }
+    return -1;
+}
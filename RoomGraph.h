@@ -0,0 +1,72 @@
+#pragma once
+#include <vector>
+#include "Grid.h"
+
+// Splits the walkable space into wall-free rectangles ("rooms") and the
+// doorways between them ("portals"), then plans on that small graph first.
+//
+// The planner is approximate: a doorway is entered and left at its middle cell,
+// so the room route (and A* restricted to its rooms) can be longer than the
+// optimum. plan() also computes a lower bound on the optimum from the full
+// doorway spans, which bounds how far off the found path can be.
+class RoomGraph
+{
+public:
+    struct Room
+    {
+        int r0 = 0, c0 = 0;   // top-left (inclusive)
+        int r1 = 0, c1 = 0;   // bottom-right (inclusive)
+
+        int area() const { return (r1 - r0 + 1) * (c1 - c0 + 1); }
+        bool contains(int r, int c) const { return r >= r0 && r <= r1 && c >= c0 && c <= c1; }
+    };
+
+    struct Portal
+    {
+        int roomA = -1, roomB = -1;
+        int cellA = -1, cellB = -1;   // middle of the doorway, one cell on each side
+        int width = 0;                // number of adjacent cell pairs in the doorway
+        Room spanA, spanB;            // every doorway cell on each side
+    };
+
+    void build(const Grid& grid);
+    void clear();
+
+    // Plans Start->Goal on the room graph and marks every cell of the rooms on the
+    // chosen route in mask (rows*cols, 1 = searchable). Returns false if no route.
+    bool plan(const Node* start, const Node* goal, std::vector<char>& mask);
+
+    // Greedy maximal-rectangle cover of the walkable cells (shared with other engines).
+    // Walls are read from the grid's wall table, which must be up to date.
+    static void decompose(const Grid& grid, std::vector<Room>& rooms, std::vector<int>& roomOf);
+
+    // Covers only the still-unassigned walkable cells (roomOf == -1) inside the box,
+    // appending the new rectangles. Used for local rebuilds after a wall edit.
+    static void decomposeRegion(const Grid& grid, const Room& box,
+        std::vector<Room>& rooms, std::vector<int>& roomOf);
+
+    bool empty() const { return m_rooms.empty(); }
+    int roomOf(int cellIdx) const { return m_roomOf[cellIdx]; }
+    const std::vector<Room>& rooms() const { return m_rooms; }
+    const std::vector<Portal>& portals() const { return m_portals; }
+    const std::vector<int>& lastRoute() const { return m_route; }
+
+    // Lower bound on the true shortest Start->Goal length from the last plan(), -1 if none.
+    // A found length L is at most L / lowerBound() times the optimum.
+    int lowerBound() const { return m_lowerBound; }
+
+private:
+    void buildPortals();
+    int spanLowerBound(int startCell, int goalCell, int startRoom, int goalRoom) const;
+
+    int m_rows = 0;
+    int m_cols = 0;
+
+    std::vector<Room> m_rooms;
+    std::vector<int> m_roomOf;                   // per cell, -1 for walls
+    std::vector<Portal> m_portals;
+    std::vector<std::vector<int>> m_roomPortals; // per room, indices into m_portals
+
+    std::vector<int> m_route;                    // rooms on the last planned route
+    int m_lowerBound = -1;
+};
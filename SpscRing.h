@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+// Fixed-size single-producer / single-consumer ring buffer.
+//
+// One thread may push() and one other thread may pop(); neither ever blocks or
+// takes a lock. The producer only writes m_head and the consumer only writes
+// m_tail, each published with release and read with acquire, so a slot's
+// contents are visible before the index that hands it over. Capacity is rounded
+// up to a power of two and one slot stays empty to tell "full" from "empty".
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(size_t capacity = 1024)
+    {
+        size_t n = 2;
+        while (n < capacity + 1) n <<= 1;
+        m_slots.resize(n);
+        m_mask = n - 1;
+    }
+
+    // Producer side. False when the ring is full (the consumer is behind).
+    bool push(const T& item)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t next = (head + 1) & m_mask;
+        if (next == m_tail.load(std::memory_order_acquire)) return false;
+
+        m_slots[head] = item;
+        m_head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. False when there is nothing to read.
+    bool pop(T& out)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) return false;
+
+        out = m_slots[tail];
+        m_tail.store((tail + 1) & m_mask, std::memory_order_release);
+        return true;
+    }
+
+    // Only while no producer is running (e.g. after joining it)
+    void clear()
+    {
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return m_mask; }
+    size_t sizeApprox() const
+    {
+        return (m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire)) & m_mask;
+    }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask = 0;
+
+    // Separate cache lines so producer and consumer do not invalidate each other
+    alignas(64) std::atomic<size_t> m_head{ 0 };   // next slot to write
+    alignas(64) std::atomic<size_t> m_tail{ 0 };   // next slot to read
+};
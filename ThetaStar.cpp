@@ -0,0 +1,282 @@
+#include "ThetaStar.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+// 8-connected moves: the four straight ones first
+static const int DR[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+static const int DC[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+void ThetaStar::build(const Grid& grid)
+{
+    m_rows = grid.rows();
+    m_cols = grid.cols();
+    m_rowWords = (m_cols + 63) / 64;
+    m_colWords = (m_rows + 63) / 64;
+    m_byRow.assign((size_t)m_rows * m_rowWords, 0);
+    m_byCol.assign((size_t)m_cols * m_colWords, 0);
+
+    const std::vector<Node*>& nodes = grid.getAllNodes();
+    for (int r = 0; r < m_rows; r++)
+        for (int c = 0; c < m_cols; c++)
+            if (!nodes[r * m_cols + c]->walkable) onWallToggled(r, c, true);
+}
+
+void ThetaStar::clear()
+{
+    cancel();
+    m_rows = m_cols = 0;
+    m_byRow.clear();
+    m_byCol.clear();
+}
+
+void ThetaStar::onWallToggled(int r, int c, bool wall)
+{
+    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return;
+
+    uint64_t& rowWord = m_byRow[(size_t)r * m_rowWords + (c >> 6)];
+    uint64_t& colWord = m_byCol[(size_t)c * m_colWords + (r >> 6)];
+    const uint64_t rowBit = uint64_t(1) << (c & 63);
+    const uint64_t colBit = uint64_t(1) << (r & 63);
+    if (wall) { rowWord |= rowBit; colWord |= colBit; }
+    else { rowWord &= ~rowBit; colWord &= ~colBit; }
+}
+
+bool ThetaStar::spanClear(const std::vector<uint64_t>& bits, int words, int line, int from, int to)
+{
+    const uint64_t* w = &bits[(size_t)line * words];
+    const int w0 = from >> 6;
+    const int w1 = to >> 6;
+    const uint64_t lo = ~uint64_t(0) << (from & 63);
+    const uint64_t hi = ~uint64_t(0) >> (63 - (to & 63));
+
+    if (w0 == w1) return (w[w0] & lo & hi) == 0;
+    if (w[w0] & lo) return false;
+    for (int i = w0 + 1; i < w1; i++)
+        if (w[i]) return false;
+    return (w[w1] & hi) == 0;
+}
+
+bool ThetaStar::segmentClear(const std::vector<uint64_t>& bits, int words, int length,
+    int x0, int y0, int x1, int y1)
+{
+    // Doubled coordinates: a cell centre is (2x + 1, 2y + 1) and line y spans
+    // [2y, 2y + 2]. Everything stays in integers, so a segment through a cell
+    // corner is caught exactly.
+    if (y0 > y1) { std::swap(x0, x1); std::swap(y0, y1); }
+    const long long dx = x1 - x0;
+    const long long dy = y1 - y0;
+    if (dy == 0) return spanClear(bits, words, y0 / 2, std::min(x0, x1) / 2, std::max(x0, x1) / 2);
+
+    for (int line = y0 / 2; line <= y1 / 2; line++)
+    {
+        // x range of the segment inside this line, scaled by dy
+        const long long ylo = std::max(2 * line, y0);
+        const long long yhi = std::min(2 * line + 2, y1);
+        long long a = x0 * dy + dx * (ylo - y0);
+        long long b = x0 * dy + dx * (yhi - y0);
+        if (a > b) std::swap(a, b);
+
+        // Every cell whose span [2x, 2x + 2] touches [a, b] / dy, boundaries included
+        const long long span = 2 * dy;
+        const int from = std::max(0, (int)((a + span - 1) / span) - 1);
+        const int to = std::min(length - 1, (int)(b / span));
+        if (!spanClear(bits, words, line, from, to)) return false;
+    }
+    return true;
+}
+
+bool ThetaStar::lineOfSight(int from, int to) const
+{
+    const int r0 = from / m_cols, c0 = from % m_cols;
+    const int r1 = to / m_cols, c1 = to % m_cols;
+
+    // Scan whichever board gives the fewer spans
+    if (std::abs(r1 - r0) <= std::abs(c1 - c0))
+        return segmentClear(m_byRow, m_rowWords, m_cols, 2 * c0 + 1, 2 * r0 + 1, 2 * c1 + 1, 2 * r1 + 1);
+    return segmentClear(m_byCol, m_colWords, m_rows, 2 * r0 + 1, 2 * c0 + 1, 2 * r1 + 1, 2 * c1 + 1);
+}
+
+bool ThetaStar::free(int r, int c) const
+{
+    if (r < 0 || r >= m_rows || c < 0 || c >= m_cols) return false;
+    return ((m_byRow[(size_t)r * m_rowWords + (c >> 6)] >> (c & 63)) & 1) == 0;
+}
+
+float ThetaStar::distance(int a, int b) const
+{
+    const float dr = (float)(a / m_cols - b / m_cols);
+    const float dc = (float)(a % m_cols - b % m_cols);
+    return std::sqrt(dr * dr + dc * dc);
+}
+
+bool ThetaStar::moveAllowed(int r, int c, int dr, int dc) const
+{
+    if (!free(r + dr, c + dc)) return false;
+    return dr == 0 || dc == 0 || (free(r + dr, c) && free(r, c + dc));   // no corner cutting
+}
+
+void ThetaStar::start(Grid& grid, Node* start, Node* goal)
+{
+    cancel();
+    if (!start || !goal || empty()) return;
+
+    m_grid = &grid;
+    m_startCell = start->row * m_cols + start->col;
+    m_goalCell = goal->row * m_cols + goal->col;
+
+    // Wall-free bounding box: every cell the straight segment touches lies inside it
+    if (!grid.anyWall(start->row, start->col, goal->row, goal->col))
+    {
+        m_parent.assign(m_rows * m_cols, -1);
+        m_parent[m_startCell] = m_startCell;
+        m_parent[m_goalCell] = m_startCell;
+        buildPath();
+        m_emptyBox = true;
+        return;
+    }
+
+    const int n = m_rows * m_cols;
+    m_g.assign(n, 1e9f);
+    m_parent.assign(n, -1);
+    m_closed.assign(n, 0);
+
+    m_g[m_startCell] = 0.0f;
+    m_parent[m_startCell] = m_startCell;
+    m_open.push_back({ distance(m_startCell, m_goalCell), 0.0f, m_startCell });
+}
+
+void ThetaStar::setVertex(int cell)
+{
+    // The parent was taken on trust when the cell was generated; check it now
+    const int p = m_parent[cell];
+    if (p == cell) return;
+    m_losChecks++;
+    if (lineOfSight(p, cell)) return;
+
+    // Blocked: the best closed neighbour (the one that generated the cell is one)
+    const int r = cell / m_cols;
+    const int c = cell % m_cols;
+    int best = -1;
+    float bestG = 1e9f;
+    for (int d = 0; d < 8; d++)
+    {
+        if (!moveAllowed(r, c, DR[d], DC[d])) continue;
+        const int nb = (r + DR[d]) * m_cols + c + DC[d];
+        if (!m_closed[nb]) continue;
+
+        const float g = m_g[nb] + distance(nb, cell);
+        if (g < bestG) { bestG = g; best = nb; }
+    }
+    m_g[cell] = bestG;
+    m_parent[cell] = best;
+}
+
+Pathfinder::Result ThetaStar::step()
+{
+    if (m_startCell < 0 || m_goalCell < 0) return Pathfinder::Result::NoPath;
+    if (m_emptyBox) return Pathfinder::Result::Found;
+    std::greater<OpenEntry> cmp;
+
+    while (!m_open.empty())
+    {
+        std::pop_heap(m_open.begin(), m_open.end(), cmp);
+        const OpenEntry e = m_open.back();
+        m_open.pop_back();
+
+        // Closed already, or superseded by a cheaper copy pushed later
+        if (m_closed[e.cell] || e.g != m_g[e.cell]) continue;
+
+        setVertex(e.cell);
+        if (e.cell == m_goalCell)
+        {
+            buildPath();
+            return Pathfinder::Result::Found;
+        }
+
+        m_closed[e.cell] = 1;
+        m_expanded++;
+        if (e.cell != m_startCell) m_grid->getAllNodes()[e.cell]->state = NodeVizState::Closed;
+
+        // Every neighbour is offered the expanded cell's parent straight away
+        const int r = e.cell / m_cols;
+        const int c = e.cell % m_cols;
+        const int p = m_parent[e.cell];
+        for (int d = 0; d < 8; d++)
+        {
+            if (!moveAllowed(r, c, DR[d], DC[d])) continue;
+            const int nb = (r + DR[d]) * m_cols + c + DC[d];
+            if (m_closed[nb]) continue;
+
+            const float g = m_g[p] + distance(p, nb);
+            if (g >= m_g[nb]) continue;
+
+            m_g[nb] = g;
+            m_parent[nb] = p;
+            m_open.push_back({ g + distance(nb, m_goalCell), g, nb });
+            std::push_heap(m_open.begin(), m_open.end(), cmp);
+
+            if (nb != m_goalCell) m_grid->getAllNodes()[nb]->state = NodeVizState::Open;
+        }
+        return Pathfinder::Result::Running;
+    }
+    return Pathfinder::Result::NoPath;
+}
+
+void ThetaStar::appendSegment(int from, int to, std::vector<int>& cells) const
+{
+    // Walk the cells the segment passes through (Amanatides-Woo), one 4-neighbour
+    // step at a time. The next row or column boundary is crossed at 1, 3, 5...
+    // half-cells from the start centre; on a tie (a corner) the column step goes
+    // first. Line of sight already cleared both cells beside the corner.
+    int r = from / m_cols, c = from % m_cols;
+    const int tr = to / m_cols, tc = to % m_cols;
+    const long long adx = 2LL * std::abs(tc - c);
+    const long long ady = 2LL * std::abs(tr - r);
+    const int sx = (tc > c) ? 1 : -1;
+    const int sy = (tr > r) ? 1 : -1;
+    long long nx = 1, ny = 1;
+
+    while (r != tr || c != tc)
+    {
+        if (adx != 0 && (ady == 0 || nx * ady <= ny * adx)) { c += sx; nx += 2; }
+        else { r += sy; ny += 2; }
+        cells.push_back(r * m_cols + c);
+    }
+}
+
+void ThetaStar::buildPath()
+{
+    m_waypoints.clear();
+    for (int cell = m_goalCell; ; cell = m_parent[cell])
+    {
+        m_waypoints.push_back(cell);
+        if (cell == m_startCell) break;
+    }
+    std::reverse(m_waypoints.begin(), m_waypoints.end());
+
+    std::vector<int> cells{ m_startCell };
+    m_length = 0.0f;
+    for (size_t i = 1; i < m_waypoints.size(); i++)
+    {
+        m_length += distance(m_waypoints[i - 1], m_waypoints[i]);
+        appendSegment(m_waypoints[i - 1], m_waypoints[i], cells);
+    }
+    m_path = Path(std::move(cells), m_cols);
+}
+
+void ThetaStar::cancel()
+{
+    m_startCell = -1;
+    m_goalCell = -1;
+    m_g.clear();
+    m_parent.clear();
+    m_closed.clear();
+    m_open.clear();
+    m_expanded = 0;
+    m_losChecks = 0;
+    m_emptyBox = false;
+    m_waypoints.clear();
+    m_length = 0.0f;
+    m_path.clear();
+}
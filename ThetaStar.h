@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Grid.h"
+#include "Pathfinder.h"
+
+// Any-angle search (Lazy Theta*, Nash et al.) over cell centres.
+//
+// The search runs on the 8-connected grid (diagonals only where both side cells
+// are free), but a generated cell takes its parent's parent when that saves
+// distance, without checking. The check is deferred to the expansion: if the
+// parent cannot see the cell, it falls back to the best closed neighbour. That
+// is one line-of-sight test per expansion instead of one per generated cell.
+//
+// Line of sight reads packed wall bitboards (64 cells per word, one copy by
+// rows and one by columns). A segment covers a contiguous span in every row
+// (or column) it crosses, and each span is tested a whole word at a time.
+// Segments may not touch a wall, not even at a corner.
+class ThetaStar
+{
+public:
+    void build(const Grid& grid);
+    void clear();
+    bool empty() const { return m_cols == 0; }
+
+    // Keeps the bitboards in step with a single toggled cell
+    void onWallToggled(int r, int c, bool wall);
+
+    bool lineOfSight(int from, int to) const;   // row-major cells
+
+    void start(Grid& grid, Node* start, Node* goal);
+    Pathfinder::Result step();
+    void cancel();
+
+    int expandedCount() const { return m_expanded; }
+    int losChecks() const { return m_losChecks; }
+    bool usedEmptyBox() const { return m_emptyBox; }   // no walls between Start and Goal: one segment, no search
+
+    // After step() returned Found: the turning points, Start first, and their
+    // Euclidean length in cells
+    const std::vector<int>& waypoints() const { return m_waypoints; }
+    float length() const { return m_length; }
+
+    // The same route as the 4-connected cells each segment passes through
+    const Path& path() const { return m_path; }
+
+private:
+    struct OpenEntry
+    {
+        float f, g;
+        int cell;
+        bool operator>(const OpenEntry& o) const
+        {
+            if (f != o.f) return f > o.f;
+            return g < o.g;   // deeper first on ties
+        }
+    };
+
+    static bool spanClear(const std::vector<uint64_t>& bits, int words, int line, int from, int to);
+    static bool segmentClear(const std::vector<uint64_t>& bits, int words, int lines,
+        int x0, int y0, int x1, int y1);
+
+    bool free(int r, int c) const;
+    float distance(int a, int b) const;
+    bool moveAllowed(int r, int c, int dr, int dc) const;
+    void setVertex(int cell);
+    void appendSegment(int from, int to, std::vector<int>& cells) const;
+    void buildPath();
+
+    int m_rows = 0;
+    int m_cols = 0;
+    int m_rowWords = 0;                 // words per row of m_byRow
+    int m_colWords = 0;                 // words per column of m_byCol
+    std::vector<uint64_t> m_byRow;      // bit c of row r: wall at (r, c)
+    std::vector<uint64_t> m_byCol;      // bit r of column c: wall at (r, c)
+
+    Grid* m_grid = nullptr;
+    int m_startCell = -1;
+    int m_goalCell = -1;
+    std::vector<float> m_g;
+    std::vector<int> m_parent;
+    std::vector<char> m_closed;
+    std::vector<OpenEntry> m_open;      // binary heap, stale entries skipped on pop
+
+    int m_expanded = 0;
+    int m_losChecks = 0;
+    bool m_emptyBox = false;
+    std::vector<int> m_waypoints;
+    float m_length = 0.0f;
+    Path m_path;
+};